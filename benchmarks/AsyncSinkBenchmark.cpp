@@ -0,0 +1,88 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Compares the per-message encode latency of writing every message inline with write(2)
+// against serializing into an AsyncSink.
+
+#include <BMLib/AsyncSink.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace BMLib;
+
+static constexpr std::size_t MESSAGES = 200000;
+
+static void encodeMessage(BinaryStream *stream, std::size_t i)
+{
+	stream->write<std::uint8_t>(0x42);
+	stream->writeVarInt<std::uint64_t>(i);
+	stream->write<std::uint32_t>(static_cast<std::uint32_t>(i * 7), false);
+	stream->writeFloat<double>(i * 0.5, false);
+	stream->writeStringVarInt("player-name");
+}
+
+static void report(const char *name, std::vector<double> &latencies)
+{
+	std::sort(latencies.begin(), latencies.end());
+	printf("%-8s p50: %8.0f ns  p99: %8.0f ns  p99.9: %8.0f ns  max: %8.0f ns\n", name,
+		latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies[latencies.size() * 999 / 1000], latencies.back());
+}
+
+int main(int argc, char **argv)
+{
+	const char *path = argc > 1 ? argv[1] : "async_sink_benchmark.bin";
+	int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		perror("open");
+		return 1;
+	}
+
+	std::vector<double> latencies(MESSAGES);
+
+	BinaryStream inline_stream(Buffer::create(true, 256));
+	for (std::size_t i = 0; i < MESSAGES; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		encodeMessage(&inline_stream, i);
+		Buffer *buffer = inline_stream.getBuffer();
+		if (::write(fd, buffer->binary, buffer->position) < 0)
+			perror("write");
+		buffer->position = 0;
+		latencies[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+	report("inline", latencies);
+
+	{
+		AsyncSink sink(fd, 4);
+		for (std::size_t i = 0; i < MESSAGES; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			encodeMessage(sink.getStream(), i);
+			sink.commit();
+			latencies[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		}
+		sink.close();
+	}
+	report("async", latencies);
+
+	::close(fd);
+	std::remove(path);
+	return 0;
+}
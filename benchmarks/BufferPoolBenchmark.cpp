@@ -0,0 +1,65 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Compares creating and destroying short-lived heap buffers on several threads
+// with the BufferPool disabled (malloc/free) and enabled.
+
+#include <BMLib/BufferPool.hpp>
+#include <BMLib/Buffer.hpp>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace BMLib;
+
+static constexpr std::size_t THREADS = 4;
+static constexpr std::size_t ROUNDS = 1000000;
+static constexpr std::size_t SIZES[] = {200, 900, 3000, 12000};
+
+static void run(const char *name)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for (std::size_t t = 0; t < THREADS; ++t)
+		workers.emplace_back([] {
+			std::uint8_t payload[12000] = {};
+			for (std::size_t round = 0; round < ROUNDS; ++round) {
+				Buffer buffer = Buffer::create();
+				buffer.writeAligned(payload, SIZES[round & 3]);
+			}
+		});
+	for (std::thread &worker : workers)
+		worker.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("%-8s %8.2f M buffers/s\n", name, static_cast<double>(THREADS * ROUNDS) / seconds / 1e6);
+}
+
+int main()
+{
+	run("malloc");
+
+	BufferPool::Config config;
+	config.enabled = true;
+	BufferPool::configure(config);
+	run("pooled");
+
+	BufferPool::Stats stats = BufferPool::getStats();
+	printf("hits: %zu, misses: %zu, retained: %zu bytes\n", stats.hits, stats.misses, stats.retained_bytes);
+	return 0;
+}
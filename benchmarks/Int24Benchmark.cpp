@@ -0,0 +1,80 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Compares decoding and encoding 24-bit samples one value at a time through read<int24_t>/write<int24_t>
+// against the bulk readInt24Array/writeInt24Array conversions.
+
+#include <BMLib/BinaryStream.hpp>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace BMLib;
+
+static constexpr std::size_t SAMPLES = 1 << 20;
+static constexpr std::size_t ROUNDS = 50;
+
+static void report(const char *name, std::chrono::steady_clock::time_point start)
+{
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("%-14s %8.2f GB/s (24-bit side)\n", name, static_cast<double>(SAMPLES * 3 * ROUNDS) / seconds / 1e9);
+}
+
+int main()
+{
+	std::vector<std::int32_t> samples(SAMPLES);
+	for (std::size_t i = 0; i < SAMPLES; ++i)
+		samples[i] = static_cast<std::int32_t>(i * 40503 % 16777216) - 8388608;
+	std::vector<std::int32_t> decoded(SAMPLES);
+	BinaryStream stream(Buffer::create(true, SAMPLES * 3));
+	std::int64_t checksum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t round = 0; round < ROUNDS; ++round) {
+		stream.getBuffer()->clear();
+		for (std::size_t i = 0; i < SAMPLES; ++i)
+			stream.write<int24_t>(samples[i], false);
+	}
+	report("write<int24_t>", start);
+
+	start = std::chrono::steady_clock::now();
+	for (std::size_t round = 0; round < ROUNDS; ++round) {
+		stream.getBuffer()->clear();
+		stream.writeInt24Array(samples.data(), SAMPLES, false);
+	}
+	report("writeInt24Array", start);
+
+	start = std::chrono::steady_clock::now();
+	for (std::size_t round = 0; round < ROUNDS; ++round) {
+		stream.rewind();
+		for (std::size_t i = 0; i < SAMPLES; ++i)
+			decoded[i] = stream.read<int24_t>(false);
+		checksum += decoded[round];
+	}
+	report("read<int24_t>", start);
+
+	start = std::chrono::steady_clock::now();
+	for (std::size_t round = 0; round < ROUNDS; ++round) {
+		stream.rewind();
+		stream.readInt24Array(decoded.data(), SAMPLES, false);
+		checksum += decoded[round];
+	}
+	report("readInt24Array", start);
+
+	printf("checksum: %lld\n", static_cast<long long>(checksum));
+	return 0;
+}
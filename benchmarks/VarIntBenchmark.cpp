@@ -0,0 +1,67 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Measures decoding varints one value at a time through readVarInt with a mix of lengths.
+
+#include <BMLib/BinaryStream.hpp>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace BMLib;
+
+static constexpr std::size_t VALUES = 1 << 20;
+static constexpr std::size_t ROUNDS = 50;
+
+template <typename T>
+static void run(const char *name, const std::vector<T> &values)
+{
+	BinaryStream stream(Buffer::create(true, VALUES * 10));
+	for (T value : values)
+		stream.writeVarInt<T>(value);
+	std::size_t bytes = stream.getBuffer()->size;
+	T checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t round = 0; round < ROUNDS; ++round) {
+		stream.rewind();
+		for (std::size_t i = 0; i < VALUES; ++i)
+			checksum += stream.readVarInt<T>();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("%-10s %8.1f M values/s %8.2f GB/s (checksum %llu)\n", name, static_cast<double>(VALUES * ROUNDS) / seconds / 1e6, static_cast<double>(bytes * ROUNDS) / seconds / 1e9, static_cast<unsigned long long>(checksum));
+}
+
+int main()
+{
+	std::vector<std::uint32_t> small(VALUES);
+	std::vector<std::uint32_t> mixed32(VALUES);
+	std::vector<std::uint64_t> mixed64(VALUES);
+	std::uint64_t seed = 88172645463325252ull;
+	for (std::size_t i = 0; i < VALUES; ++i) {
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		small[i] = static_cast<std::uint32_t>(seed & 0x7f);
+		mixed32[i] = static_cast<std::uint32_t>(seed >> (seed % 32 + 32));
+		mixed64[i] = seed >> (seed % 64);
+	}
+	run("1 byte", small);
+	run("mixed u32", mixed32);
+	run("mixed u64", mixed64);
+	return 0;
+}
@@ -0,0 +1,112 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#ifndef _WIN32
+
+#include "BinaryStream.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BMLib
+{
+	/// The AsyncSink class.
+	/// Serializes into one of several stream buffers on the calling thread while a background thread
+	/// writes the filled buffers to a file descriptor with writev.
+	///
+	/// The calling thread writes a message through getStream() and then calls commit().
+	/// Once the active buffer reaches the high-water mark it is handed to the background thread
+	/// and a free buffer becomes active (the caller only blocks if every buffer is still being written).
+	/// Only one thread may write into the sink.
+	class AsyncSink
+	{
+	public:
+		static constexpr std::size_t DEFAULT_BUFFER_COUNT = 2;
+		static constexpr std::size_t DEFAULT_HIGH_WATER_MARK = 64 * 1024;
+
+		/// \brief Initializes a new AsyncSink instance and starts the background thread.
+		///
+		/// \param[in] fd The file descriptor to write into (it is not closed by the sink), a non-blocking one
+		/// is waited on with poll when it would block so no byte is dropped.
+		/// \param[in] buffer_count The number of buffers, at least two.
+		/// \param[in] high_water_mark The number of bytes after which the active buffer is handed off on commit.
+		explicit AsyncSink(int fd, std::size_t buffer_count = DEFAULT_BUFFER_COUNT, std::size_t high_water_mark = DEFAULT_HIGH_WATER_MARK);
+
+		/// \brief Destructor for the AsyncSink class.
+		/// This closes the sink, writing every pending byte.
+		~AsyncSink();
+
+		AsyncSink(const AsyncSink &) = delete;
+		AsyncSink &operator=(const AsyncSink &) = delete;
+
+		/// \brief Retrieves the stream of the active buffer.
+		/// The active stream can change on every commit(), so it should be retrieved for every message.
+		///
+		/// \return A pointer to the active BinaryStream.
+		BinaryStream *getStream();
+
+		/// \brief Marks the end of a message and hands off the active buffer if it reached the high-water mark.
+		///
+		/// \throws std::system_error if the background thread failed to write.
+		void commit();
+
+		/// \brief Hands off the active buffer and waits until every pending byte was written.
+		///
+		/// \throws std::system_error if the background thread failed to write.
+		void flush();
+
+		/// \brief Flushes the sink and stops the background thread.
+		/// Writing into a closed sink is not allowed, closing it again does nothing.
+		///
+		/// \throws std::system_error if the background thread failed to write (the thread is stopped first).
+		void close();
+
+		/// \brief Retrieves the number of bytes written to the file descriptor.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfBytesWritten() const;
+
+	private:
+		int fd;
+		std::size_t high_water_mark;
+		std::vector<BinaryStream> streams;
+		BinaryStream *active;
+		std::deque<BinaryStream *> free_streams;
+		std::deque<BinaryStream *> pending_streams;
+		std::size_t in_flight;
+		bool closing;
+		bool closed;
+		int error;
+		std::atomic<std::size_t> bytes_written;
+		std::mutex mutex;
+		std::condition_variable work_cv;
+		std::condition_variable done_cv;
+		std::thread worker;
+
+		void internalSubmit();
+		void internalErrorCheck();
+		void internalRun();
+		int internalWrite(const std::vector<BinaryStream *> &batch);
+	};
+}
+
+#endif
@@ -0,0 +1,115 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#ifndef _WIN32
+
+#include "Buffer.hpp"
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+namespace BMLib
+{
+	/// The BatchReceiver class.
+	/// Receives many datagrams (recvmmsg) or stream chunks (readv) per syscall directly into a slab of
+	/// preallocated buffers, so the received data is decoded in place without a scratch copy.
+	///
+	/// Every received buffer holds its data from position 0 up to its size and can be handed straight to
+	/// a BinaryStream. Buffers given back with recycle() are reused by the next receive, so a steady
+	/// receive loop stops allocating once the slab is warm.
+	class BatchReceiver
+	{
+	public:
+		static constexpr std::size_t DEFAULT_SLOT_COUNT = 64;
+		static constexpr std::size_t DEFAULT_SLOT_SIZE = 2048;
+
+		/// \brief Initializes a new BatchReceiver instance and allocates its slab.
+		///
+		/// \param[in] fd The file descriptor to receive from (it is not closed by the receiver).
+		/// \param[in] slot_count The largest number of buffers filled per receive, at least one.
+		/// \param[in] slot_size The size of each buffer, datagrams larger than it are dropped.
+		explicit BatchReceiver(int fd, std::size_t slot_count = DEFAULT_SLOT_COUNT, std::size_t slot_size = DEFAULT_SLOT_SIZE);
+
+		BatchReceiver(const BatchReceiver &) = delete;
+		BatchReceiver &operator=(const BatchReceiver &) = delete;
+
+		/// \brief Receives the pending datagrams of a datagram socket, one datagram per buffer.
+		/// This waits for the first datagram only if the socket is blocking.
+		///
+		/// \param[out] out The vector the filled buffers are appended to.
+		///
+		/// \return The number of buffers appended, 0 if the socket would block.
+		/// \throws std::system_error if the receive failed.
+		std::size_t receiveDatagrams(std::vector<Buffer> &out);
+
+		/// \brief Reads the pending bytes of a stream descriptor, filling each buffer before the next one.
+		/// The buffers split the byte stream at arbitrary points, so messages can span buffers.
+		///
+		/// \param[out] out The vector the filled buffers are appended to.
+		///
+		/// \return The number of buffers appended, 0 if the descriptor would block or reached its end (see eof).
+		/// \throws std::system_error if the read failed.
+		std::size_t receiveStream(std::vector<Buffer> &out);
+
+		/// \brief Gives a received buffer back to the slab.
+		/// Buffers that do not own plain heap binary data (wrapped, adopted or allocator backed ones),
+		/// no longer hold a slot or do not fit in the slab are freed instead.
+		///
+		/// \param[in] buffer The buffer to recycle.
+		void recycle(Buffer &&buffer);
+
+		/// \brief Gives every buffer of a vector back to the slab and clears the vector (see recycle).
+		///
+		/// \param[in] buffers The buffers to recycle.
+		void recycle(std::vector<Buffer> &buffers);
+
+		/// \brief Checks if receiveStream reached the end of the stream.
+		///
+		/// \return Condition of the action.
+		bool eof() const;
+
+		/// \brief Retrieves the number of buffers allocated for the slab so far.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfAllocations() const;
+
+		/// \brief Retrieves the number of datagrams dropped for being larger than a slot.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfTruncated() const;
+
+	private:
+		int fd;
+		std::size_t slot_count;
+		std::size_t slot_size;
+		std::vector<Buffer> free_buffers;
+		std::vector<iovec> vectors;
+#ifdef __linux__
+		std::vector<mmsghdr> headers;
+#endif
+		bool end_of_stream;
+		std::size_t allocations;
+		std::size_t truncated;
+
+		void internalRefill();
+		std::size_t internalPrepare();
+	};
+}
+
+#endif
@@ -0,0 +1,97 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#ifndef _WIN32
+
+#include "Buffer.hpp"
+#include "BufferView.hpp"
+#include <sys/uio.h>
+#include <vector>
+
+namespace BMLib
+{
+	/// The BatchWriter class.
+	/// Gathers many independent buffers and writes them to a file descriptor with as few writev calls
+	/// as possible (up to IOV_MAX buffers per call).
+	///
+	/// Only pointers to the data are kept, so every added buffer must stay alive and unchanged until it is flushed.
+	/// A flush that stops early (a non-blocking descriptor that would block, or an error) keeps the unwritten
+	/// part queued, so the next flush resumes exactly where the previous one stopped.
+	class BatchWriter
+	{
+	public:
+		/// \brief Initializes a new BatchWriter instance.
+		///
+		/// \param[in] fd The file descriptor to write into (it is not closed by the writer).
+		explicit BatchWriter(int fd);
+
+		BatchWriter(const BatchWriter &) = delete;
+		BatchWriter &operator=(const BatchWriter &) = delete;
+
+		/// \brief Queues the written part of a buffer (from the start up to its size).
+		///
+		/// \param[in] buffer The buffer to queue.
+		void add(const Buffer &buffer);
+
+		/// \brief Queues the viewed binary data.
+		///
+		/// \param[in] view The data to queue.
+		void add(BufferView view);
+
+		/// \brief Writes the queued data until everything was written or the descriptor would block.
+		///
+		/// \return The number of bytes written by this call.
+		/// \throws std::system_error if writev failed, the unwritten data stays queued.
+		std::size_t flush();
+
+		/// \brief Drops the queued data without writing it.
+		void clear();
+
+		/// \brief Checks if there is no queued data left.
+		///
+		/// \return Condition of the action.
+		bool empty() const;
+
+		/// \brief Retrieves the number of queued bytes that were not written yet.
+		///
+		/// \return The resulting value.
+		std::size_t getPendingSize() const;
+
+		/// \brief Retrieves the number of bytes written to the file descriptor.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfBytesWritten() const;
+
+		/// \brief Retrieves the number of writev calls issued.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfCalls() const;
+
+	private:
+		int fd;
+		std::vector<iovec> vectors;
+		// the first vector that was not completely written.
+		std::size_t index;
+		std::size_t pending_size;
+		std::size_t bytes_written;
+		std::size_t calls;
+	};
+}
+
+#endif
@@ -17,39 +17,85 @@
 
 #pragma once
 
+#include "BoolArray.hpp"
 #include "Buffer.hpp"
+#include "BufferView.hpp"
+#include "Encoding.hpp"
 #include "exceptions/EndOfStream.hpp"
+#include "exceptions/FrameTooBig.hpp"
 #include "exceptions/VarIntTooBig.hpp"
 #include "exceptions/ZigZagTooBig.hpp"
 #include "exceptions/PaddingOutOfRange.hpp"
+#include "Int24Array.hpp"
 #include "Integers.hpp"
+#include "StreamPolicies.hpp"
+#include "Utf8.hpp"
 #include <cmath>
 #include <type_traits>
 #include <string>
 #include <optional>
 #include <functional>
+#include <memory>
 #include <algorithm>
+#include <bitset>
+#include <vector>
 #include <cstring>
 
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 namespace BMLib
 {
-	class BinaryStream
+	/// The BasicBinaryStream class.
+	/// Reads and writes binary data with the byte order and the read bounds checking chosen at compile time,
+	/// so streams with a fixed policy compile down to code without those branches.
+	/// Every combination of the policies in StreamPolicies.hpp is instantiated by the library.
+	///
+	/// \tparam Endian The byte order policy (RuntimeEndian, BigEndian or LittleEndian).
+	/// \tparam Checking The read bounds checking policy (Checked, DebugChecked or Unchecked).
+	template <typename Endian = RuntimeEndian, typename Checking = Checked>
+	class BasicBinaryStream
 	{
 	public:
-		/// \brief Initializes a new BinaryStream instance.
+		/// \brief Initializes a new BasicBinaryStream instance with an empty auto reallocating buffer.
+		BasicBinaryStream();
+
+		/// \brief Initializes a new BasicBinaryStream instance.
+		///
+		/// \param[in] buffer The buffer to use.
+		/// \param[in] position The reading position.
+		explicit BasicBinaryStream(Buffer &&buffer, std::size_t position = 0);
+
+		/// \brief Initializes a new BasicBinaryStream instance that takes ownership of a heap allocated buffer.
+		/// The binary data is moved into the stream and the Buffer object is deleted.
 		///
 		/// \param[in] buffer The buffer to use.
 		/// \param[in] position The reading position.
-		explicit BinaryStream(Buffer *buffer, std::size_t position);
+		explicit BasicBinaryStream(std::unique_ptr<Buffer> buffer, std::size_t position = 0);
 
-		/// \brief Destructor for the BinaryStream class.
-		/// This deallocates the buffer and resets the stream to its default state.
-		~BinaryStream();
+		// the stream holds its buffer by value, so a raw pointer would dangle or free a buffer the caller owns.
+		BasicBinaryStream(Buffer *buffer, std::size_t position) = delete;
+
+		BasicBinaryStream(BasicBinaryStream &&other) noexcept;
+		BasicBinaryStream &operator=(BasicBinaryStream &&other) noexcept;
+
+		BasicBinaryStream(const BasicBinaryStream &) = delete;
+		BasicBinaryStream &operator=(const BasicBinaryStream &) = delete;
+
+		/// \brief Destructor for the BasicBinaryStream class.
+		/// This deallocates the buffer.
+		~BasicBinaryStream();
+
+		/// \brief Copies the stream, including its buffer and reading position.
+		///
+		/// \return The copied stream.
+		BasicBinaryStream clone() const;
 
 		/// \brief Rewinds the reading position.
 		void rewind();
 
-		/// \brief Destroys the buffer then allocates a new buffer.
+		/// \brief Destroys the buffer then allocates a new buffer with the same alignment and allocator.
 		///
 		/// \param[in] auto_realloc Enable automatic reallocation for the new buffer.
 		/// \param[in] alloc_size The allocation size for the new buffer.
@@ -61,7 +107,15 @@ namespace BMLib
 		/// \brief Deallocates the buffer and sets it to the new buffer specified.
 		///
 		/// \param[in] buffer The buffer to set to.
-		void setBuffer(Buffer *buffer);
+		void setBuffer(Buffer &&buffer);
+
+		/// \brief Deallocates the buffer and takes ownership of a heap allocated buffer.
+		/// The binary data is moved into the stream and the Buffer object is deleted.
+		///
+		/// \param[in] buffer The buffer to set to.
+		void setBuffer(std::unique_ptr<Buffer> buffer);
+
+		void setBuffer(Buffer *buffer) = delete;
 
 		/// \brief Checks if the end of the stream was reached.
 		///
@@ -104,6 +158,14 @@ namespace BMLib
 		/// \throws EndOfStream error
 		Buffer *readAligned(std::size_t size);
 
+		/// \brief Reads aligned binary from the current position in the buffer without copying or allocating.
+		///
+		/// \param[in] size The size of data to read from the buffer.
+		///
+		/// \return A view of the read binary data, valid until the buffer is modified.
+		/// \throws EndOfStream error
+		BufferView readView(std::size_t size);
+
 		/// \brief Reads a single unsigned byte from the current position in the buffer.
 		///
 		/// \return The resulting unsigned byte value.
@@ -114,45 +176,45 @@ namespace BMLib
 		///
 		/// \tparam T the type that will be written.
 		/// \param[in] value The value to write into the buffer.
-		/// \param[in] big_endian Whether to use big endian byte order.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
 		template <typename T>
 		std::enable_if_t<std::is_arithmetic_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> || (std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>)> write(T value, bool big_endian = true)
 		{
-			std::size_t size = sizeof(T);
-			if (size == 1) {
-				this->buffer->writeSingle(static_cast<std::uint8_t>(value));
-				return;
+			if constexpr (sizeof(T) == 1)
+				this->buffer.writeSingle(static_cast<std::uint8_t>(value));
+			else {
+				std::uint8_t bytes[sizeof(T)] = {};
+				encoding::encodeFixed<T>(value, bytes, Endian::resolve(big_endian));
+				this->buffer.writeAligned(bytes, sizeof(T));
 			}
-			std::size_t safe_value = static_cast<std::size_t>(value);
-			for (std::size_t i = 0; i < size; ++i)
-				this->write<std::uint8_t>(static_cast<std::uint8_t>(safe_value >> static_cast<std::uint8_t>((big_endian ? (size - i - 1) : i) << 3)));
 		}
 
 		/// \brief Writes a floating-point number based on what the template type is.
 		///
 		/// \tparam T the type that will be written.
 		/// \param[in] value The value to write into the buffer.
-		/// \param[in] big_endian Whether to use big endian byte order.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
 		template <typename T>
 		std::enable_if_t<std::is_floating_point_v<T>> writeFloat(T value, bool big_endian = true)
 		{
-			std::size_t size = sizeof(T);
-			std::size_t bit_pattern;
-			std::memcpy(&bit_pattern, &value, size);
-			for (std::size_t i = 0; i < size; ++i)
-				this->write<std::uint8_t>(static_cast<std::uint8_t>(bit_pattern >> ((big_endian ? (size - i - 1) : i) << 3)));
+			using bits_type = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+			bits_type bit_pattern;
+			std::memcpy(&bit_pattern, &value, sizeof(T));
+			std::uint8_t bytes[sizeof(T)] = {};
+			encoding::encodeFixed<bits_type>(bit_pattern, bytes, Endian::resolve(big_endian));
+			this->buffer.writeAligned(bytes, sizeof(T));
 		}
 
 		/// \brief Writes a string value to the buffer.
 		///
 		/// \tparam T the type that will be used to write the string length.
 		/// \param[in] value The value to write into the buffer.
-		/// \param[in] big_endian Whether to use big endian byte order.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
 		template <typename T>
 		std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> && !(std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>)> writeString(std::string value, bool big_endian = true)
 		{
 			this->write<T>(static_cast<T>(value.size()), big_endian);
-			this->buffer->writeAligned((std::uint8_t *)value.data(), value.size());
+			this->buffer.writeAligned((std::uint8_t *)value.data(), value.size());
 		}
 
 		/// \brief Writes a varint string value to the buffer.
@@ -163,7 +225,7 @@ namespace BMLib
 		std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> && !(std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>)> writeStringVarInt(std::string value)
 		{
 			this->writeVarInt<T>(static_cast<T>(value.size()));
-			this->buffer->writeAligned((std::uint8_t *)value.data(), value.size());
+			this->buffer.writeAligned((std::uint8_t *)value.data(), value.size());
 		}
 
 		/// \brief Writes a varint value to the buffer.
@@ -173,16 +235,8 @@ namespace BMLib
 		template <typename T = std::uint32_t>
 		std::enable_if_t<std::is_arithmetic_v<T> && !std::is_floating_point_v<T> && !std::is_array_v<T> && std::is_unsigned_v<T>> writeVarInt(T value)
 		{
-			for (std::size_t i = 0; i < std::ceil((sizeof(T) << 3) / 7); ++i) {
-				std::uint8_t to_write = value & 0x7f;
-				value >>= 7;
-				if (value)
-					this->write<uint8_t>(to_write | 0x80);
-				else {
-					this->write<uint8_t>(to_write);
-					break;
-				}
-			}
+			std::uint8_t bytes[encoding::maxVarIntSize<T>()] = {};
+			this->buffer.writeAligned(bytes, encoding::encodeVarInt<T>(value, bytes));
 		}
 
 		/// \brief Writes a zigzag value to the buffer.
@@ -192,8 +246,48 @@ namespace BMLib
 		template <typename T = std::int32_t>
 		std::enable_if_t<std::is_arithmetic_v<T> && !std::is_floating_point_v<T> && !std::is_array_v<T> && std::is_signed_v<T>> writeZigZag(T value)
 		{
-			auto to_write = static_cast<std::make_unsigned_t<T>>(value);
-			this->writeVarInt<decltype(to_write)>((to_write << 1) ^ (to_write >> ((sizeof(T) << 3) - 1)));
+			this->writeVarInt<std::make_unsigned_t<T>>(encoding::encodeZigZag<T>(value));
+		}
+
+		/// \brief Writes an array of 24-bit unsigned integers to the buffer (the top byte of every value is dropped).
+		///
+		/// \param[in] values The values to write.
+		/// \param[in] count The number of values.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
+		void writeUInt24Array(const std::uint32_t *values, std::size_t count, bool big_endian = true);
+
+		/// \brief Writes an array of 24-bit signed integers to the buffer (the top byte of every value is dropped).
+		///
+		/// \param[in] values The values to write.
+		/// \param[in] count The number of values.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
+		void writeInt24Array(const std::int32_t *values, std::size_t count, bool big_endian = true);
+
+		/// \brief Writes flags packed 8 per byte to the buffer.
+		/// The flags start at the next byte, they do not continue a bit octet left by writeBit.
+		///
+		/// \param[in] values The flags to write.
+		/// \param[in] count The number of flags.
+		/// \param[in] msb_o Packs the first flag of every byte into its MSb (the same order as writeBit).
+		void writeBoolArray(const bool *values, std::size_t count, bool msb_o = true);
+
+		/// \brief Writes flags packed 8 per byte to the buffer (see the bool array overload).
+		///
+		/// \param[in] values The flags to write.
+		/// \param[in] msb_o Packs the first flag of every byte into its MSb (the same order as writeBit).
+		void writeBoolArray(const std::vector<bool> &values, bool msb_o = true)
+		{
+			this->internalWriteFlags(values, values.size(), msb_o);
+		}
+
+		/// \brief Writes the bits of a bitset packed 8 per byte to the buffer, starting with bit 0 (see the bool array overload).
+		///
+		/// \param[in] values The flags to write.
+		/// \param[in] msb_o Packs the first flag of every byte into its MSb (the same order as writeBit).
+		template <std::size_t N>
+		void writeBoolArray(const std::bitset<N> &values, bool msb_o = true)
+		{
+			this->internalWriteFlags(values, N, msb_o);
 		}
 
 		/// \brief Writes a padding to the buffer.
@@ -209,10 +303,14 @@ namespace BMLib
 		/// \param[in] msb_o Writes from the MSB to LSB.
 		void writeBit(bool value, bool skip = false, bool msb_o = true);
 
+		/// \brief Writes the partially filled bit octet (if any) to the buffer
+		/// and resets the bit writer.
+		void flushBitWriter();
+
 		/// \brief Writes an optional value to the buffer.
 		///
 		/// \param[in] value The function that will be called if the function not nullopt.
-		void writeOptional(std::optional<std::function<void(BinaryStream *)>> value);
+		void writeOptional(std::optional<std::function<void(BasicBinaryStream *)>> value);
 
 		/// \brief Writes bits to the buffer (does not work for floating-point types).
 		///
@@ -226,57 +324,80 @@ namespace BMLib
 				this->writeBit(((value >> (msb_o ? (size - i - 1) : i)) & 0b1) == 1);
 		}
 
+		/// \brief Reserves a fixed-width length prefix at the current position, which endLengthPrefixed
+		/// fills in with the number of bytes written after it. Prefixes can be nested.
+		/// Replacing the buffer (reset, destroy or setBuffer) drops the open prefixes.
+		///
+		/// \tparam T the type of the length prefix.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
+		template <typename T>
+		std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>> beginLengthPrefixed(bool big_endian = true)
+		{
+			static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "Length prefixes must be 1, 2, 4 or 8 bytes wide.");
+			this->internalBeginLengthPrefixed(sizeof(T), false, Endian::resolve(big_endian), false);
+		}
+
+		/// \brief Reserves a varint length prefix of the largest size the type can take (see beginLengthPrefixed).
+		///
+		/// \tparam T the type of the length prefix.
+		/// \param[in] compact Whether endLengthPrefixed shrinks the prefix to its minimal size by moving the
+		/// data back, otherwise the prefix keeps the reserved size as a padded varint.
+		template <typename T = std::uint32_t>
+		std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>> beginLengthPrefixedVarInt(bool compact = true)
+		{
+			this->internalBeginLengthPrefixed(encoding::maxVarIntSize<T>(), true, false, compact);
+		}
+
+		/// \brief Fills in the innermost length prefix reserved by beginLengthPrefixed/beginLengthPrefixedVarInt.
+		///
+		/// \return The number of bytes written after the prefix.
+		/// \throws FrameTooBig error if the length does not fit in the prefix.
+		/// \throws std::runtime_error if no prefix is open or the buffer no longer holds it.
+		std::size_t endLengthPrefixed();
+
 		/// \brief Reads a type based on what the template type is.
 		///
 		/// \tparam T the type that will be read.
-		/// \param[in] big_endian Whether to use big endian byte order.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
 		///
 		/// \return The T value read from the buffer.
 		template <typename T>
 		std::enable_if_t<std::is_arithmetic_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> || (std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>), T> read(bool big_endian = true)
 		{
-			std::size_t size = sizeof(T);
-			if (size == 1)
-				return static_cast<T>(this->readSingle());
-
-			std::size_t result = 0;
-			for (std::size_t i = 0; i < size; ++i)
-				result |= static_cast<std::size_t>(this->read<std::uint8_t>()) << ((big_endian ? (size - i - 1) : i) << 3);
-			return static_cast<T>(result);
+			if constexpr (sizeof(T) == 1)
+				return static_cast<T>(*this->internalRead(1));
+			else
+				return encoding::decodeFixed<T>(this->internalRead(sizeof(T)), Endian::resolve(big_endian));
 		}
 
 		/// \brief Reads a floating-point number based on what the template type is.
 		///
 		/// \tparam T the type that will be read.
-		/// \param[in] big_endian Whether to use big endian byte order.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
 		///
 		/// \return The T value read from the buffer.
 		template <typename T>
 		std::enable_if_t<std::is_floating_point_v<T>, T> readFloat(bool big_endian = true)
 		{
-			std::size_t size = sizeof(T);
-			Buffer *bit_pattern_buffer = this->readAligned(size);
-			std::size_t result = 0;
-			for (size_t i = 0; i < size; ++i)
-				result |= static_cast<std::size_t>(bit_pattern_buffer->at(i)) << ((big_endian ? (size - i - 1) : i) << 3);
-			delete bit_pattern_buffer;
-			return *reinterpret_cast<T *>(&result);
+			using bits_type = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+			bits_type bit_pattern = encoding::decodeFixed<bits_type>(this->internalRead(sizeof(T)), Endian::resolve(big_endian));
+			T value;
+			std::memcpy(&value, &bit_pattern, sizeof(T));
+			return value;
 		}
 
 		/// \brief Reads a string value based on what the template type is.
 		///
 		/// \tparam T the type that will be used to read the string length.
-		/// \param[in] big_endian Whether to use big endian byte order.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
 		///
 		/// \return The string value read from the buffer.
 		template <typename T>
 		std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> && !(std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>), std::string> readString(bool big_endian = true)
 		{
 			T str_size = this->read<T>(big_endian);
-			Buffer *tmp_buf = this->readAligned(str_size);
-			std::uint8_t *bytes = tmp_buf->binary;
-			delete tmp_buf;
-			return std::string((char *)bytes, str_size);
+			BufferView bytes = this->readView(str_size);
+			return std::string((const char *)bytes.binary, bytes.size);
 		}
 
 		/// \brief Reads a varint string value based on what the template type is.
@@ -288,10 +409,38 @@ namespace BMLib
 		std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> && !(std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>), std::string> readStringVarInt()
 		{
 			T str_size = this->readVarInt<T>();
-			Buffer *tmp_buf = this->readAligned(str_size);
-			std::uint8_t *bytes = tmp_buf->binary;
-			delete tmp_buf;
-			return std::string((char *)bytes, str_size);
+			BufferView bytes = this->readView(str_size);
+			return std::string((const char *)bytes.binary, bytes.size);
+		}
+
+		/// \brief Reads a string value and validates it as UTF-8 in the same pass, without throwing on invalid data.
+		/// An invalid string is still consumed so reading can continue after it.
+		///
+		/// \tparam T the type that will be used to read the string length.
+		/// \param[out] value The string read, left unchanged if it is not valid UTF-8.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
+		///
+		/// \return Whether the string is valid UTF-8.
+		/// \throws EndOfStream error
+		template <typename T>
+		std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> && !(std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>), bool> readValidatedString(std::string &value, bool big_endian = true)
+		{
+			T str_size = this->read<T>(big_endian);
+			return this->internalReadValidated(value, str_size);
+		}
+
+		/// \brief Reads a varint string value and validates it as UTF-8 (see readValidatedString).
+		///
+		/// \tparam T the type that will be used to read the string length.
+		/// \param[out] value The string read, left unchanged if it is not valid UTF-8.
+		///
+		/// \return Whether the string is valid UTF-8.
+		/// \throws EndOfStream error
+		template <typename T = std::uint32_t>
+		std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> && !(std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>), bool> readValidatedStringVarInt(std::string &value)
+		{
+			T str_size = this->readVarInt<T>();
+			return this->internalReadValidated(value, str_size);
 		}
 
 		/// \brief Reads a varint value from the buffer.
@@ -302,10 +451,35 @@ namespace BMLib
 		template <typename T = std::uint32_t>
 		std::enable_if_t<std::is_arithmetic_v<T> && !std::is_floating_point_v<T> && !std::is_array_v<T> && std::is_unsigned_v<T>, T> readVarInt()
 		{
-			std::size_t value = 0;
-			for (std::size_t i = 0; i < std::ceil((sizeof(T) << 3) / 7.0) * 7; i += 7) {
+			constexpr std::size_t max_size = encoding::maxVarIntSize<T>();
+			std::uint64_t value = 0;
+			std::size_t shift = 0;
+			// with 8 bytes left the first 8 bytes are decoded from a single load.
+			if (this->buffer.binary && this->position <= this->buffer.size && this->buffer.size - this->position >= 8) {
+				const std::uint8_t *in = this->buffer.binary + this->position;
+				if (in[0] < 0x80) {
+					++this->position;
+					return static_cast<T>(in[0]);
+				}
+				std::uint64_t word = encoding::decodeFixed<std::uint64_t>(in, false);
+				std::uint64_t terminators = ~word & 0x8080808080808080;
+				if (terminators != 0) {
+					std::size_t size = internalLowestByte(terminators) + 1;
+					if (size > max_size)
+						throw exceptions::VarIntTooBig("Attempted to decode VarInt that is too big to be represented.");
+					this->position += size;
+					// keeps the bytes up to the terminator (the lowest set bit of terminators).
+					return static_cast<T>(internalPackVarInt(word & (terminators ^ (terminators - 1))));
+				}
+				if constexpr (max_size <= 8)
+					throw exceptions::VarIntTooBig("Attempted to decode VarInt that is too big to be represented.");
+				this->position += 8;
+				value = internalPackVarInt(word);
+				shift = 56;
+			}
+			for (; shift < max_size * 7; shift += 7) {
 				std::uint8_t to_read = this->read<std::uint8_t>();
-				value |= static_cast<T>(to_read & 0x7f) << i;
+				value |= static_cast<std::uint64_t>(to_read & 0x7f) << shift;
 				if ((to_read & 0x80) == 0)
 					return static_cast<T>(value);
 			}
@@ -327,8 +501,52 @@ namespace BMLib
 			} catch (...) {
 				throw exceptions::ZigZagTooBig("Attempted to decode ZigZag that is too big to be represented.");
 			}
-			T value = static_cast<T>(varint);
-			return (value >> 1) ^ -(value & 1);
+			return encoding::decodeZigZag<T>(varint);
+		}
+
+		/// \brief Reads an array of 24-bit unsigned integers from the buffer.
+		///
+		/// \param[out] values The values read (count values).
+		/// \param[in] count The number of values.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
+		/// \throws EndOfStream error
+		void readUInt24Array(std::uint32_t *values, std::size_t count, bool big_endian = true);
+
+		/// \brief Reads an array of 24-bit signed integers from the buffer, sign extended to 32 bits.
+		///
+		/// \param[out] values The values read (count values).
+		/// \param[in] count The number of values.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
+		/// \throws EndOfStream error
+		void readInt24Array(std::int32_t *values, std::size_t count, bool big_endian = true);
+
+		/// \brief Reads flags packed 8 per byte from the buffer.
+		///
+		/// \param[out] values The flags read (count values).
+		/// \param[in] count The number of flags.
+		/// \param[in] msb_o Whether the first flag of every byte is in its MSb (the same order as readBit).
+		/// \throws EndOfStream error
+		void readBoolArray(bool *values, std::size_t count, bool msb_o = true);
+
+		/// \brief Reads as many flags as the vector holds (see the bool array overload).
+		///
+		/// \param[out] values The flags read.
+		/// \param[in] msb_o Whether the first flag of every byte is in its MSb (the same order as readBit).
+		/// \throws EndOfStream error
+		void readBoolArray(std::vector<bool> &values, bool msb_o = true)
+		{
+			this->internalReadFlags(values, values.size(), msb_o);
+		}
+
+		/// \brief Reads the bits of a bitset, starting with bit 0 (see the bool array overload).
+		///
+		/// \param[out] values The flags read.
+		/// \param[in] msb_o Whether the first flag of every byte is in its MSb (the same order as readBit).
+		/// \throws EndOfStream error
+		template <std::size_t N>
+		void readBoolArray(std::bitset<N> &values, bool msb_o = true)
+		{
+			this->internalReadFlags(values, N, msb_o);
 		}
 
 		/// \brief Reads a padding from the buffer.
@@ -337,8 +555,23 @@ namespace BMLib
 		/// \param[in] size The number of how much the value was padded.
 		///
 		/// \return A Buffer instance representing the padded values.
+		/// \throws PaddingOutOfRange error
 		Buffer *readPadding(std::uint8_t value, std::size_t size);
 
+		/// \brief Reads the bytes up to a delimiter without copying them, the delimiter is consumed but not included.
+		///
+		/// \param[in] delimiter The byte that ends the data.
+		///
+		/// \return A view of the bytes before the delimiter, valid until the buffer is modified.
+		/// \throws EndOfStream error if the delimiter is not found.
+		BufferView readUntil(std::uint8_t delimiter);
+
+		/// \brief Reads a null terminated string without copying it (see readUntil).
+		///
+		/// \return A view of the string without its terminator, valid until the buffer is modified.
+		/// \throws EndOfStream error if the terminator is not found.
+		BufferView readCString();
+
 		/// \brief Reads a bit from the buffer.
 		///
 		/// \param[in] skip Whether to skip to a new octet without waiting until the bit is completely read.
@@ -350,7 +583,7 @@ namespace BMLib
 		/// \brief Reads an optional value to the buffer.
 		///
 		/// \param[in] value The function that will be called if the optional value is found.
-		void readOptional(std::optional<std::function<void(BinaryStream *)>> value);
+		void readOptional(std::optional<std::function<void(BasicBinaryStream *)>> value);
 
 		/// \brief Reads bits from the buffer.
 		///
@@ -363,7 +596,7 @@ namespace BMLib
 		{
 			T result = 0;
 			for (std::size_t i = 0; i < size; ++i)
-				result |= static_cast<std::uint8_t>(this->readBit()) << (msb_o ? (size - i - 1) : i);
+				result |= static_cast<T>(this->readBit()) << (msb_o ? (size - i - 1) : i);
 			return result;
 		}
 
@@ -372,8 +605,85 @@ namespace BMLib
 		/// \return A pointer to the Buffer object representing the remaining buffer.
 		Buffer *readRemaining();
 
+		/// \brief Skips a value based on what the template type is, without decoding it.
+		///
+		/// \tparam T the type that will be skipped.
+		/// \throws EndOfStream error
+		template <typename T>
+		std::enable_if_t<std::is_arithmetic_v<T> && !std::is_array_v<T> || (std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>)> skip()
+		{
+			this->internalRead(sizeof(T));
+		}
+
+		/// \brief Skips a varint value by finding its last byte, without assembling it.
+		///
+		/// \tparam T the type the varint was written as.
+		/// \throws EndOfStream error
+		/// \throws VarIntTooBig error
+		template <typename T = std::uint32_t>
+		std::enable_if_t<std::is_arithmetic_v<T> && !std::is_floating_point_v<T> && !std::is_array_v<T> && std::is_unsigned_v<T>> skipVarInt()
+		{
+			this->internalSkipVarInt(encoding::maxVarIntSize<T>());
+		}
+
+		/// \brief Skips a zigzag value (see skipVarInt).
+		///
+		/// \tparam T the type the zigzag was written as.
+		/// \throws EndOfStream error
+		/// \throws ZigZagTooBig error
+		template <typename T = std::int32_t>
+		std::enable_if_t<std::is_arithmetic_v<T> && !std::is_floating_point_v<T> && !std::is_array_v<T> && std::is_signed_v<T>> skipZigZag()
+		{
+			try {
+				this->internalSkipVarInt(encoding::maxVarIntSize<std::make_unsigned_t<T>>());
+			} catch (exceptions::VarIntTooBig &) {
+				throw exceptions::ZigZagTooBig("Attempted to decode ZigZag that is too big to be represented.");
+			}
+		}
+
+		/// \brief Skips a string value without copying it.
+		///
+		/// \tparam T the type that was used to write the string length.
+		/// \param[in] big_endian Whether to use big endian byte order (only used by RuntimeEndian).
+		/// \throws EndOfStream error
+		template <typename T>
+		std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> && !(std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>)> skipString(bool big_endian = true)
+		{
+			this->internalRead(this->read<T>(big_endian));
+		}
+
+		/// \brief Skips a varint string value without copying it.
+		///
+		/// \tparam T the type that was used to write the string length.
+		/// \throws EndOfStream error
+		template <typename T = std::uint32_t>
+		std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> && !(std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>)> skipStringVarInt()
+		{
+			this->internalRead(this->readVarInt<T>());
+		}
+
+		/// \brief Skips bits, continuing the octet of the bit reader.
+		///
+		/// \param[in] size The number of bits to skip.
+		/// \throws EndOfStream error
+		void skipBits(std::size_t size);
+
+		/// \brief Skips an optional value written by writeOptional.
+		///
+		/// \param[in] skip_value The function that skips the value if it is present.
+		///
+		/// \return Whether the value was present.
+		template <typename F>
+		bool skipOptional(F &&skip_value)
+		{
+			bool has_structure = this->read<bool>();
+			if (has_structure)
+				skip_value(this);
+			return has_structure;
+		}
+
 	protected:
-		Buffer *buffer;
+		Buffer buffer;
 		std::size_t position;
 		std::uint8_t curr_write_octet;
 		std::size_t curr_bit_write_pos;
@@ -381,6 +691,91 @@ namespace BMLib
 		std::size_t curr_bit_read_pos;
 
 	private:
+		struct LengthPrefix
+		{
+			std::size_t offset;
+			std::uint8_t width;
+			bool varint;
+			bool big_endian;
+			bool compact;
+		};
+
+		// the open length prefixes, innermost last.
+		std::vector<LengthPrefix> length_prefixes;
+
+		void internalBeginLengthPrefixed(std::size_t width, bool varint, bool big_endian, bool compact);
 		void internalBufferCheck();
+		std::size_t internalArraySize(std::size_t count, std::size_t element_size);
+		bool internalReadValidated(std::string &value, std::size_t size);
+		void internalSkipVarInt(std::size_t max_size);
+
+		static constexpr std::uint8_t internalFlagMask(std::size_t index, bool msb_o)
+		{
+			return static_cast<std::uint8_t>(msb_o ? (0x80 >> (index & 7)) : (1 << (index & 7)));
+		}
+
+		template <typename Flags>
+		void internalWriteFlags(const Flags &values, std::size_t count, bool msb_o)
+		{
+			std::size_t size = (count >> 3) + ((count & 7) != 0);
+			std::uint8_t *out = this->buffer.writeUninitialized(size);
+			std::fill_n(out, size, 0);
+			for (std::size_t i = 0; i < count; ++i)
+				if (values[i])
+					out[i >> 3] |= internalFlagMask(i, msb_o);
+		}
+
+		template <typename Flags>
+		void internalReadFlags(Flags &values, std::size_t count, bool msb_o)
+		{
+			const std::uint8_t *in = this->internalRead((count >> 3) + ((count & 7) != 0));
+			for (std::size_t i = 0; i < count; ++i)
+				values[i] = (in[i >> 3] & internalFlagMask(i, msb_o)) != 0;
+		}
+
+		static std::size_t internalLowestByte(std::uint64_t word)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<std::size_t>(__builtin_ctzll(word)) >> 3;
+#else
+			std::size_t index = 0;
+			while ((word & (std::uint64_t(0xff) << (index << 3))) == 0)
+				++index;
+			return index;
+#endif
+		}
+
+		static std::uint64_t internalPackVarInt(std::uint64_t word)
+		{
+#ifdef __BMI2__
+			return _pext_u64(word, 0x7f7f7f7f7f7f7f7f);
+#else
+			return encoding::packVarIntGroups(word);
+#endif
+		}
+
+		const std::uint8_t *internalRead(std::size_t size)
+		{
+			if constexpr (Checking::enabled) {
+				this->internalBufferCheck();
+				if (this->position > this->buffer.size || size > this->buffer.size - this->position)
+					throw exceptions::EndOfStream("Attempted to read past the end of the stream. No more bytes left to read.");
+			}
+			this->position += size;
+			return this->buffer.binary + (this->position - size);
+		}
 	};
+
+	/// The default stream, which takes the byte order per call and checks every read.
+	using BinaryStream = BasicBinaryStream<>;
+
+	extern template class BasicBinaryStream<RuntimeEndian, Checked>;
+	extern template class BasicBinaryStream<RuntimeEndian, DebugChecked>;
+	extern template class BasicBinaryStream<RuntimeEndian, Unchecked>;
+	extern template class BasicBinaryStream<BigEndian, Checked>;
+	extern template class BasicBinaryStream<BigEndian, DebugChecked>;
+	extern template class BasicBinaryStream<BigEndian, Unchecked>;
+	extern template class BasicBinaryStream<LittleEndian, Checked>;
+	extern template class BasicBinaryStream<LittleEndian, DebugChecked>;
+	extern template class BasicBinaryStream<LittleEndian, Unchecked>;
 }
@@ -0,0 +1,40 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BMLib::encoding
+{
+	/// \brief Packs flags into 8 flags per byte, the last byte is padded with zero bits.
+	///
+	/// \param[in] in The flags (count values).
+	/// \param[out] out The packed flags ((count + 7) / 8 bytes).
+	/// \param[in] count The number of flags.
+	/// \param[in] msb_o Packs the first flag of every byte into its MSb instead of its LSb.
+	void encodeBoolArray(const bool *in, std::uint8_t *out, std::size_t count, bool msb_o);
+
+	/// \brief Unpacks flags packed by encodeBoolArray.
+	///
+	/// \param[in] in The packed flags ((count + 7) / 8 bytes).
+	/// \param[out] out The flags (count values).
+	/// \param[in] count The number of flags.
+	/// \param[in] msb_o Whether the first flag of every byte is in its MSb instead of its LSb.
+	void decodeBoolArray(const std::uint8_t *in, bool *out, std::size_t count, bool msb_o);
+}
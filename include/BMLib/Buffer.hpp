@@ -23,19 +23,51 @@
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
+#include <algorithm>
+
+// the number of bytes a buffer can hold before its binary data is moved to the heap.
+#ifndef BMLIB_BUFFER_INLINE_SIZE
+#define BMLIB_BUFFER_INLINE_SIZE 64
+#endif
 
 namespace BMLib
 {
+	class BufferAllocator;
+
 	/// The Buffer class.
 	/// The public fields should not be touched unless absolutely needed, and that is also the reason they are public.
+	///
+	/// Allocated buffers start in an inline array of INLINE_SIZE bytes and only move their binary data
+	/// to the heap once a write exceeds it.
+	/// The heap binary data comes from the BufferAllocator given to create/allocate, otherwise from malloc
+	/// (or from the BufferPool while it is enabled).
 	class Buffer
 	{
 	public:
+		// frees adopted binary data, context is the value given to adopt.
+		using Deleter = void (*)(std::uint8_t *binary, void *context);
+
+		// where the heap binary data starts.
+		enum class Alignment : std::uint8_t
+		{
+			// malloc alignment, taken from the BufferPool if it is enabled.
+			Default,
+			// 64-byte alignment for aligned SIMD loads.
+			CacheLine,
+			// page alignment.
+			Page,
+			// huge page backed mappings for binary data of 2 MiB or more (explicit huge pages if reserved,
+			// otherwise transparent huge pages), page alignment below that.
+			HugePage
+		};
+
 		static constexpr int DEFAULT_ALLOCATION_SIZE = 512;
+		static constexpr std::size_t INLINE_SIZE = BMLIB_BUFFER_INLINE_SIZE;
 
 		// the allocated or not binary data.
 		std::uint8_t *binary;
-		// the size of the binary data.
+		// the size of the binary data (the number of valid bytes).
 		std::size_t size;
 		// the writing position (the number of bytes written).
 		std::size_t position;
@@ -43,6 +75,8 @@ namespace BMLib
 		bool auto_realloc;
 		// whether the binary data is dynamically allocated and if not then it is statically allocated.
 		bool dynamic;
+		// the number of bytes the binary data can hold.
+		std::size_t capacity;
 
 		/// \brief Initializes a new Buffer instance.
 		///
@@ -53,17 +87,92 @@ namespace BMLib
 		/// \param[in] dynamic Whether the binary data is dynamic or not.
 		explicit Buffer(std::uint8_t *binary, std::size_t size, std::size_t position = 0, bool auto_realloc = false, bool dynamic = true);
 
-		/// \brief Allocates an unsafe variable-sized buffer.
+		/// \brief Initializes an empty Buffer instance with auto reallocation enabled, held in the inline storage.
+		Buffer();
+
+		/// \brief Initializes a new Buffer instance by taking over the binary data of another buffer.
+		/// The other buffer is left empty.
+		///
+		/// \param[in] other The buffer to take over.
+		Buffer(Buffer &&other) noexcept;
+
+		/// \brief Deallocates the binary data and takes over the binary data of another buffer.
+		/// The other buffer is left empty.
+		///
+		/// \param[in] other The buffer to take over.
+		///
+		/// \return A reference to this buffer.
+		Buffer &operator=(Buffer &&other) noexcept;
+
+		Buffer(const Buffer &) = delete;
+		Buffer &operator=(const Buffer &) = delete;
+
+		/// \brief Creates an empty unsafe variable-sized buffer by value (see allocate).
+		///
+		/// \param[in] auto_realloc_enabled Enable memeory auto reallocation.
+		/// \param[in] alloc_size The size of the binary data.
+		/// \param[in] alignment The alignment of the heap binary data.
+		/// \param[in] allocator The allocator of the heap binary data, which must outlive the buffer (nullptr uses malloc).
+		///
+		/// \return The created buffer.
+		static Buffer create(bool auto_realloc_enabled = true, std::size_t alloc_size = DEFAULT_ALLOCATION_SIZE, Alignment alignment = Alignment::Default, BufferAllocator *allocator = nullptr);
+
+		/// \brief Allocates an empty unsafe variable-sized buffer.
+		/// The buffer starts in the inline storage, if auto reallocation is enabled the first heap allocation
+		/// holds at least alloc_size bytes, otherwise alloc_size is the maximum number of bytes that can be written.
+		/// Buffers with a non-default alignment skip the inline storage and allocate alloc_size bytes right away,
+		/// and keep the alignment whenever they grow.
 		///
 		/// \param[in] auto_realloc_enabled Enable memeory auto reallocation.
 		/// \param[in] alloc_size The size of the binary data.
+		/// \param[in] alignment The alignment of the heap binary data.
+		/// \param[in] allocator The allocator of the heap binary data, which must outlive the buffer (nullptr uses malloc).
 		///
 		/// \return A Buffer object representing the allocated buffer.
-		static Buffer *allocate(bool auto_realloc_enabled = true, std::size_t alloc_size = DEFAULT_ALLOCATION_SIZE);
+		static Buffer *allocate(bool auto_realloc_enabled = true, std::size_t alloc_size = DEFAULT_ALLOCATION_SIZE, Alignment alignment = Alignment::Default, BufferAllocator *allocator = nullptr);
+
+		/// \brief Creates a buffer that takes over foreign binary data and frees it with a deleter.
+		/// Writes append after the adopted bytes, a write past them copies the binary data to the heap
+		/// and frees the adopted binary data early.
+		///
+		/// \param[in] binary The binary data to take over.
+		/// \param[in] size The size of the binary data.
+		/// \param[in] deleter The function that frees the binary data.
+		/// \param[in] context The value passed to the deleter.
+		///
+		/// \return The created buffer.
+		static Buffer adopt(std::uint8_t *binary, std::size_t size, Deleter deleter, void *context = nullptr);
+
+		/// \brief Creates a buffer that takes over the storage of a vector without copying its bytes.
+		///
+		/// \param[in] storage The vector to take over.
+		///
+		/// \return The created buffer.
+		static Buffer adopt(std::vector<std::uint8_t> &&storage);
+
+		/// \brief Creates a buffer that takes over the storage of a string without copying its bytes.
+		///
+		/// \param[in] storage The string to take over.
+		///
+		/// \return The created buffer.
+		static Buffer adopt(std::string &&storage);
+
+		/// \brief Creates a read-only buffer over foreign binary data, which must outlive the buffer.
+		///
+		/// \param[in] binary The binary data to read.
+		/// \param[in] size The size of the binary data.
+		///
+		/// \return The created buffer.
+		static Buffer wrap(const std::uint8_t *binary, std::size_t size);
 
 		/// \brief The destructor for the Buffer class, which deallocates the allocated memory.
 		~Buffer();
 
+		/// \brief Copies the valid bytes into a new buffer that owns its binary data.
+		///
+		/// \return The copied buffer.
+		Buffer clone() const;
+
 		/// \brief Writes the binary data after the current binary data.
 		///
 		/// \param[in] in_buffer The binary data to be merged with the current binary data.
@@ -71,7 +180,7 @@ namespace BMLib
 		//
 		/// \throws std::invalid_argument if the buffer size or position is negative.
 		/// \throws Binary::exceptions::EndOfStream if the buffer is at maximum size and auto reallocation is not enabled.
-		void writeAligned(std::uint8_t *in_buffer, size_t in_size);
+		void writeAligned(const std::uint8_t *in_buffer, size_t in_size);
 
 		/// \brief Writes the buffer data into the current buffer.
 		///
@@ -89,6 +198,64 @@ namespace BMLib
 		/// \throws Binary::exceptions::EndOfStream if the buffer is at maximum size and auto reallocation is not enabled.
 		void writeSingle(std::uint8_t value);
 
+		/// \brief Claims the next bytes of the binary data for the caller to fill in place.
+		/// The position and size advance as if the bytes were written, but their content is left unspecified.
+		///
+		/// \param[in] in_size The number of bytes to claim.
+		///
+		/// \return A pointer to the claimed bytes, valid until the buffer is modified.
+		/// \throws std::invalid_argument if the buffer size or position is negative.
+		/// \throws Binary::exceptions::EndOfStream if the buffer is at maximum size and auto reallocation is not enabled.
+		std::uint8_t *writeUninitialized(std::size_t in_size);
+
+		/// \brief Makes sure the binary data can hold at least the specified number of bytes.
+		///
+		/// \param[in] new_capacity The number of bytes the binary data must be able to hold.
+		///
+		/// \throws Binary::exceptions::EndOfStream if the buffer is smaller and auto reallocation is not enabled.
+		void reserve(std::size_t new_capacity);
+
+		/// \brief Gives up the ownership of heap allocated binary data and leaves the buffer empty.
+		/// The caller must free the returned binary data with std::free.
+		///
+		/// \return The binary data, or nullptr (leaving the buffer untouched) if it is inline, adopted, from an allocator or not owned by the buffer.
+		std::uint8_t *releaseBinary();
+
+		/// \brief Moves the valid bytes into a vector and leaves the buffer empty.
+		/// The bytes are only copied if the binary data was not adopted from a vector.
+		///
+		/// \return The resulting vector.
+		std::vector<std::uint8_t> releaseVector();
+
+		/// \brief Moves the valid bytes into a string and leaves the buffer empty.
+		/// The bytes are only copied if the binary data was not adopted from a string.
+		///
+		/// \return The resulting string.
+		std::string releaseString();
+
+		/// \brief Empties the buffer while keeping its binary data for reuse.
+		void clear();
+
+		/// \brief Retrieves the alignment of the heap binary data.
+		///
+		/// \return The resulting value.
+		Alignment getAlignment() const;
+
+		/// \brief Retrieves the allocator of the heap binary data.
+		///
+		/// \return The allocator, or nullptr if malloc is used.
+		BufferAllocator *getAllocator() const;
+
+		/// \brief Retrieves the deleter of adopted or platform allocated binary data.
+		///
+		/// \return The deleter, or nullptr if the buffer frees the binary data itself.
+		Deleter getDeleter() const;
+
+		/// \brief Checks if the binary data is still held in the inline storage.
+		///
+		/// \return Condition of the action.
+		bool isInline() const;
+
 		/// \brief Retrieves a byte from a specific position in the buffer.
 		///
 		/// \param[in] pos The position to retrieve the byte from.
@@ -97,7 +264,24 @@ namespace BMLib
 		std::uint8_t at(size_t pos);
 
 	private:
+		std::size_t spill_size;
+		// the number of bytes the heap binary data was allocated with.
+		std::size_t heap_capacity;
+		Alignment alignment;
+		BufferAllocator *allocator;
+		Deleter deleter;
+		void *deleter_context;
+		std::uint8_t inline_binary[INLINE_SIZE];
+
 		void internalParamsCheck();
 		void internalResize(std::size_t value);
+		void internalGrow(std::size_t min_capacity);
+		void internalReplace(std::size_t min_capacity);
+		void internalRelease();
+		void internalTake(Buffer &other);
+		void internalDetach();
+		std::size_t internalAlignmentSize() const;
+
+		static void internalFree(std::uint8_t *heap_binary, std::size_t heap_capacity);
 	};
 }
@@ -0,0 +1,136 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace BMLib
+{
+	/// The BufferAllocator class.
+	/// The memory resource buffers use for their heap binary data when one is given to Buffer::create,
+	/// in the style of std::pmr::memory_resource: the public functions keep the usage statistics
+	/// and forward to the protected virtual functions an allocator implements.
+	/// An allocator must outlive every buffer that uses it.
+	class BufferAllocator
+	{
+	public:
+		struct Stats
+		{
+			// the number of allocate calls.
+			std::size_t allocations;
+			// the number of deallocate calls.
+			std::size_t deallocations;
+			// the number of reallocate calls.
+			std::size_t reallocations;
+			// the number of bytes currently allocated.
+			std::size_t bytes_in_use;
+			// the largest number of bytes allocated at once.
+			std::size_t peak_bytes;
+		};
+
+		BufferAllocator();
+		virtual ~BufferAllocator() = default;
+
+		BufferAllocator(const BufferAllocator &) = delete;
+		BufferAllocator &operator=(const BufferAllocator &) = delete;
+
+		/// \brief Retrieves the size an allocation of the specified size would actually get,
+		/// which buffers use as their capacity.
+		///
+		/// \param[in] size The requested size.
+		///
+		/// \return The resulting value (at least size).
+		std::size_t goodSize(std::size_t size) const;
+
+		/// \brief Allocates binary data.
+		///
+		/// \param[in] size The size of the binary data.
+		/// \param[in] alignment The alignment of the binary data (a power of two).
+		///
+		/// \return The allocated binary data.
+		/// \throws std::bad_alloc error
+		std::uint8_t *allocate(std::size_t size, std::size_t alignment);
+
+		/// \brief Deallocates binary data returned by allocate or reallocate.
+		///
+		/// \param[in] binary The binary data.
+		/// \param[in] size The size it was allocated with.
+		/// \param[in] alignment The alignment it was allocated with.
+		void deallocate(std::uint8_t *binary, std::size_t size, std::size_t alignment);
+
+		/// \brief Resizes binary data, keeping its first bytes and its alignment.
+		///
+		/// \param[in] binary The binary data.
+		/// \param[in] old_size The size it was allocated with.
+		/// \param[in] new_size The new size.
+		/// \param[in] alignment The alignment it was allocated with.
+		///
+		/// \return The resized binary data.
+		/// \throws std::bad_alloc error
+		std::uint8_t *reallocate(std::uint8_t *binary, std::size_t old_size, std::size_t new_size, std::size_t alignment);
+
+		/// \brief Retrieves the usage statistics of the allocator.
+		///
+		/// \return The resulting statistics.
+		Stats getStats() const;
+
+		/// \brief Retrieves the allocator that uses malloc/realloc/free.
+		///
+		/// \return The shared instance.
+		static BufferAllocator *getDefault();
+
+	protected:
+		virtual std::uint8_t *doAllocate(std::size_t size, std::size_t alignment) = 0;
+		virtual void doDeallocate(std::uint8_t *binary, std::size_t size, std::size_t alignment) = 0;
+		// allocates, copies and deallocates by default.
+		virtual std::uint8_t *doReallocate(std::uint8_t *binary, std::size_t old_size, std::size_t new_size, std::size_t alignment);
+		virtual std::size_t doGoodSize(std::size_t size) const;
+
+	private:
+		std::atomic<std::size_t> allocations;
+		std::atomic<std::size_t> deallocations;
+		std::atomic<std::size_t> reallocations;
+		std::atomic<std::size_t> bytes_in_use;
+		std::atomic<std::size_t> peak_bytes;
+
+		void internalAdd(std::size_t size);
+	};
+
+	/// The MallocAllocator class.
+	/// Allocates with malloc/realloc/free, and posix_memalign for alignments above the malloc alignment.
+	class MallocAllocator final : public BufferAllocator
+	{
+	protected:
+		std::uint8_t *doAllocate(std::size_t size, std::size_t alignment) override;
+		void doDeallocate(std::uint8_t *binary, std::size_t size, std::size_t alignment) override;
+		std::uint8_t *doReallocate(std::uint8_t *binary, std::size_t old_size, std::size_t new_size, std::size_t alignment) override;
+	};
+
+	/// The PoolAllocator class.
+	/// Allocates from the thread-local size classes of the BufferPool (whether or not the pool is enabled
+	/// for other buffers), so every instance can keep its own statistics over the shared pool.
+	class PoolAllocator final : public BufferAllocator
+	{
+	protected:
+		std::uint8_t *doAllocate(std::size_t size, std::size_t alignment) override;
+		void doDeallocate(std::uint8_t *binary, std::size_t size, std::size_t alignment) override;
+		std::size_t doGoodSize(std::size_t size) const override;
+	};
+}
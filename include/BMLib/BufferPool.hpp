@@ -0,0 +1,111 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BMLib
+{
+	/// The BufferPool class.
+	/// Recycles the heap memory of buffers through thread-local free lists, one per power-of-two size class.
+	/// A list that grows past its cap drains half of its blocks into a global depot that other threads refill from,
+	/// and the depot frees blocks once it holds more than its byte limit, so the retained memory is bounded by
+	/// max_depot_bytes plus max_list_bytes per size class for every thread.
+	///
+	/// While the pool is enabled every Buffer allocates and frees its heap memory through it.
+	/// The blocks are regular malloc blocks, so the pool can be enabled or disabled at any time.
+	class BufferPool
+	{
+	public:
+		// the smallest size class.
+		static constexpr std::size_t MIN_CLASS_SIZE = 64;
+		// the largest size class, larger blocks are never pooled.
+		static constexpr std::size_t MAX_CLASS_SIZE = 1 << 20;
+
+		struct Config
+		{
+			// whether buffers use the pool.
+			bool enabled = false;
+			// the number of blocks a thread-local list holds before draining to the depot.
+			std::size_t max_list_length = 64;
+			// the number of bytes a thread-local list holds before draining to the depot.
+			std::size_t max_list_bytes = 256 * 1024;
+			// the number of bytes the depot holds before freeing blocks.
+			std::size_t max_depot_bytes = 64 * 1024 * 1024;
+		};
+
+		struct Stats
+		{
+			// the number of blocks served from a thread-local list or the depot.
+			std::size_t hits;
+			// the number of blocks allocated with malloc.
+			std::size_t misses;
+			// the number of blocks returned to the pool.
+			std::size_t recycled;
+			// the number of blocks freed because they did not fit a size class or the depot was full.
+			std::size_t dropped;
+			// the number of bytes held by all thread-local lists and the depot.
+			std::size_t retained_bytes;
+		};
+
+		/// \brief Changes the pool configuration, the caps apply to the following releases.
+		///
+		/// \param[in] config The configuration to use.
+		static void configure(const Config &config);
+
+		/// \brief Retrieves the pool configuration.
+		///
+		/// \return The resulting configuration.
+		static Config getConfig();
+
+		/// \brief Checks if buffers use the pool.
+		///
+		/// \return Condition of the action.
+		static bool isEnabled();
+
+		/// \brief Acquires a block of at least the specified size.
+		///
+		/// \param[in] size The minimum size of the block.
+		/// \param[out] capacity The actual size of the block (its size class).
+		///
+		/// \return The block, which can also be freed with std::free.
+		static std::uint8_t *acquire(std::size_t size, std::size_t &capacity);
+
+		/// \brief Retrieves the size of the block acquire returns for the specified size.
+		///
+		/// \param[in] size The minimum size of the block.
+		///
+		/// \return The resulting value.
+		static std::size_t roundSize(std::size_t size);
+
+		/// \brief Returns a malloc block to the pool.
+		///
+		/// \param[in] binary The block to return (nullptr is ignored).
+		/// \param[in] capacity The size of the block.
+		static void release(std::uint8_t *binary, std::size_t capacity);
+
+		/// \brief Retrieves the statistics of every thread.
+		///
+		/// \return The resulting statistics.
+		static Stats getStats();
+
+		/// \brief Frees the blocks held by the calling thread and the depot.
+		static void trim();
+	};
+}
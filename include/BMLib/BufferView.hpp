@@ -0,0 +1,92 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace BMLib
+{
+	/// The BufferView class.
+	/// A non-owning view of binary data, the data must outlive the view.
+	class BufferView
+	{
+	public:
+		// the viewed binary data.
+		const std::uint8_t *binary;
+		// the size of the viewed binary data.
+		std::size_t size;
+
+		/// \brief Initializes an empty BufferView instance.
+		constexpr BufferView() : binary(nullptr), size(0)
+		{
+		}
+
+		/// \brief Initializes a new BufferView instance.
+		///
+		/// \param[in] binary The binary data to view.
+		/// \param[in] size The size of the binary data.
+		constexpr BufferView(const std::uint8_t *binary, std::size_t size) : binary(binary), size(size)
+		{
+		}
+
+		/// \brief Checks if the view is empty.
+		///
+		/// \return Condition of the action.
+		constexpr bool empty() const
+		{
+			return this->size == 0;
+		}
+
+		/// \brief Retrieves a byte from a specific position in the view.
+		///
+		/// \param[in] pos The position to retrieve the byte from.
+		/// \return The byte value at the specified position.
+		/// \throws std::out_of_range error
+		std::uint8_t at(std::size_t pos) const
+		{
+			if (pos >= this->size)
+				throw std::out_of_range("Attempted to access byte at position " + std::to_string(pos) + ", but view size is only " + std::to_string(this->size) + " bytes.");
+			return this->binary[pos];
+		}
+
+		/// \brief Creates a view of a part of this view.
+		///
+		/// \param[in] offset The offset of the part.
+		/// \param[in] size The size of the part.
+		/// \return The resulting view.
+		/// \throws std::out_of_range error
+		BufferView subview(std::size_t offset, std::size_t size) const
+		{
+			if (offset > this->size || size > this->size - offset)
+				throw std::out_of_range("Attempted to view " + std::to_string(size) + " bytes at offset " + std::to_string(offset) + ", but view size is only " + std::to_string(this->size) + " bytes.");
+			return BufferView(this->binary + offset, size);
+		}
+
+		const std::uint8_t *begin() const
+		{
+			return this->binary;
+		}
+
+		const std::uint8_t *end() const
+		{
+			return this->binary + this->size;
+		}
+	};
+}
@@ -0,0 +1,155 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Integers.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace BMLib::encoding
+{
+	namespace detail
+	{
+		// the byte loops are unrolled through a fold so the compiler can merge them into a single (byte swapped) load or store.
+		template <std::size_t... I>
+		constexpr void encodeFixedBytes(std::uint64_t value, std::uint8_t *out, bool big_endian, std::index_sequence<I...>)
+		{
+			constexpr std::size_t size = sizeof...(I);
+			((out[I] = static_cast<std::uint8_t>(value >> ((big_endian ? (size - I - 1) : I) << 3))), ...);
+		}
+
+		template <std::size_t... I>
+		constexpr std::uint64_t decodeFixedBytes(const std::uint8_t *in, bool big_endian, std::index_sequence<I...>)
+		{
+			constexpr std::size_t size = sizeof...(I);
+			return ((static_cast<std::uint64_t>(in[I]) << ((big_endian ? (size - I - 1) : I) << 3)) | ...);
+		}
+	}
+
+	/// \brief Retrieves the largest number of bytes a varint of the type can take.
+	///
+	/// \tparam T the varint type.
+	///
+	/// \return The resulting value.
+	template <typename T>
+	constexpr std::size_t maxVarIntSize()
+	{
+		return ((sizeof(T) << 3) + 6) / 7;
+	}
+
+	/// \brief Encodes a fixed-width integer.
+	///
+	/// \tparam T the type that will be encoded.
+	/// \param[in] value The value to encode.
+	/// \param[out] out The output, which must hold at least sizeof(T) bytes.
+	/// \param[in] big_endian Whether to use big endian byte order.
+	template <typename T>
+	constexpr void encodeFixed(T value, std::uint8_t *out, bool big_endian)
+	{
+		detail::encodeFixedBytes(static_cast<std::uint64_t>(value), out, big_endian, std::make_index_sequence<sizeof(T)>());
+	}
+
+	/// \brief Decodes a fixed-width integer.
+	///
+	/// \tparam T the type that will be decoded.
+	/// \param[in] in The input, which must hold at least sizeof(T) bytes.
+	/// \param[in] big_endian Whether to use big endian byte order.
+	///
+	/// \return The decoded value.
+	template <typename T>
+	constexpr T decodeFixed(const std::uint8_t *in, bool big_endian)
+	{
+		return static_cast<T>(detail::decodeFixedBytes(in, big_endian, std::make_index_sequence<sizeof(T)>()));
+	}
+
+	/// \brief Encodes an unsigned varint.
+	///
+	/// \tparam T the type that will be encoded.
+	/// \param[in] value The value to encode.
+	/// \param[out] out The output, which must hold at least maxVarIntSize<T>() bytes.
+	///
+	/// \return The number of bytes encoded.
+	template <typename T>
+	constexpr std::size_t encodeVarInt(T value, std::uint8_t *out)
+	{
+		std::size_t size = 0;
+		while (value >= 0x80) {
+			out[size++] = static_cast<std::uint8_t>((value & 0x7f) | 0x80);
+			value >>= 7;
+		}
+		out[size++] = static_cast<std::uint8_t>(value);
+		return size;
+	}
+
+	/// \brief Retrieves the number of bytes encodeVarInt takes for a value.
+	///
+	/// \tparam T the type that will be encoded.
+	/// \param[in] value The value to measure.
+	///
+	/// \return The resulting value.
+	template <typename T>
+	constexpr std::size_t varIntSize(T value)
+	{
+		std::size_t size = 1;
+		while (value >= 0x80) {
+			value >>= 7;
+			++size;
+		}
+		return size;
+	}
+
+	/// \brief Packs the 7-bit groups of up to 8 varint bytes loaded as a little endian word
+	/// (the bytes after the last one must be cleared).
+	///
+	/// \param[in] word The varint bytes.
+	///
+	/// \return The value of the varint bytes.
+	constexpr std::uint64_t packVarIntGroups(std::uint64_t word)
+	{
+		word &= 0x7f7f7f7f7f7f7f7f;
+		word = (word & 0x007f007f007f007f) | ((word & 0x7f007f007f007f00) >> 1);
+		word = (word & 0x00003fff00003fff) | ((word & 0x3fff00003fff0000) >> 2);
+		return (word & 0x000000000fffffff) | ((word & 0x0fffffff00000000) >> 4);
+	}
+
+	/// \brief Maps a signed value to the unsigned value written as its zigzag varint.
+	///
+	/// \tparam T the signed type.
+	/// \param[in] value The value to map.
+	///
+	/// \return The mapped value.
+	template <typename T>
+	constexpr std::make_unsigned_t<T> encodeZigZag(T value)
+	{
+		using U = std::make_unsigned_t<T>;
+		return static_cast<U>(static_cast<U>(value) << 1) ^ static_cast<U>(value >> ((sizeof(T) << 3) - 1));
+	}
+
+	/// \brief Maps an unsigned zigzag value back to the signed value.
+	///
+	/// \tparam T the signed type.
+	/// \param[in] value The value to map.
+	///
+	/// \return The mapped value.
+	template <typename T>
+	constexpr T decodeZigZag(std::make_unsigned_t<T> value)
+	{
+		return static_cast<T>((value >> 1) ^ (~(value & 1) + 1));
+	}
+}
@@ -0,0 +1,201 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "BufferView.hpp"
+#include "Encoding.hpp"
+#include "Integers.hpp"
+#include "exceptions/EndOfStream.hpp"
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace BMLib
+{
+	/// The FixedWriter class.
+	/// A fixed-capacity writer usable in constant expressions, so packets whose bytes never change
+	/// can be built at compile time and stored in read-only data.
+	/// It produces the same bytes as the matching BinaryStream writes.
+	///
+	/// Example:
+	///
+	///     constexpr auto keep_alive = [] {
+	///         BMLib::FixedWriter<8> writer;
+	///         writer.write<std::uint8_t>(0x01);
+	///         writer.writeVarInt<std::uint32_t>(300);
+	///         return writer;
+	///     }();
+	///     static constexpr auto keep_alive_bytes = keep_alive.toArray<keep_alive.getNumOfBytesWritten()>();
+	///
+	/// \tparam N The capacity in bytes.
+	template <std::size_t N>
+	class FixedWriter
+	{
+	public:
+		/// \brief Initializes an empty FixedWriter instance.
+		constexpr FixedWriter() : binary{}, position(0)
+		{
+		}
+
+		/// \brief Writes a type based on what the template type is (see BinaryStream::write).
+		///
+		/// \tparam T the type that will be written.
+		/// \param[in] value The value to write.
+		/// \param[in] big_endian Whether to use big endian byte order.
+		/// \throws EndOfStream error (a compile error in a constant expression)
+		template <typename T>
+		constexpr std::enable_if_t<std::is_arithmetic_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T> || (std::is_same_v<T, uint24_t> || std::is_same_v<T, int24_t>)> write(T value, bool big_endian = true)
+		{
+			this->internalCheck(sizeof(T));
+			encoding::encodeFixed<T>(value, this->binary.data() + this->position, big_endian);
+			this->position += sizeof(T);
+		}
+
+		/// \brief Writes a varint value (see BinaryStream::writeVarInt).
+		///
+		/// \tparam T the type that will be written.
+		/// \param[in] value The value to write.
+		/// \throws EndOfStream error (a compile error in a constant expression)
+		template <typename T = std::uint32_t>
+		constexpr std::enable_if_t<std::is_arithmetic_v<T> && !std::is_floating_point_v<T> && !std::is_array_v<T> && std::is_unsigned_v<T>> writeVarInt(T value)
+		{
+			std::uint8_t bytes[encoding::maxVarIntSize<T>()] = {};
+			this->writeAligned(bytes, encoding::encodeVarInt<T>(value, bytes));
+		}
+
+		/// \brief Writes a zigzag value (see BinaryStream::writeZigZag).
+		///
+		/// \tparam T the type that will be written.
+		/// \param[in] value The value to write.
+		/// \throws EndOfStream error (a compile error in a constant expression)
+		template <typename T = std::int32_t>
+		constexpr std::enable_if_t<std::is_arithmetic_v<T> && !std::is_floating_point_v<T> && !std::is_array_v<T> && std::is_signed_v<T>> writeZigZag(T value)
+		{
+			this->writeVarInt<std::make_unsigned_t<T>>(encoding::encodeZigZag<T>(value));
+		}
+
+		/// \brief Writes a string value (see BinaryStream::writeString).
+		///
+		/// \tparam T the type that will be used to write the string length.
+		/// \param[in] value The value to write.
+		/// \param[in] big_endian Whether to use big endian byte order.
+		/// \throws EndOfStream error (a compile error in a constant expression)
+		template <typename T>
+		constexpr std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T>> writeString(std::string_view value, bool big_endian = true)
+		{
+			this->write<T>(static_cast<T>(value.size()), big_endian);
+			this->internalWriteChars(value);
+		}
+
+		/// \brief Writes a varint string value (see BinaryStream::writeStringVarInt).
+		///
+		/// \tparam T the type that will be used to write the string length.
+		/// \param[in] value The value to write.
+		/// \throws EndOfStream error (a compile error in a constant expression)
+		template <typename T = std::uint32_t>
+		constexpr std::enable_if_t<std::is_arithmetic_v<T> && std::is_unsigned_v<T> && !std::is_array_v<T> && !std::is_floating_point_v<T>> writeStringVarInt(std::string_view value)
+		{
+			this->writeVarInt<T>(static_cast<T>(value.size()));
+			this->internalWriteChars(value);
+		}
+
+		/// \brief Writes a padding (see BinaryStream::writePadding).
+		///
+		/// \param[in] value The number that will be padded.
+		/// \param[in] size The number of how much the value will be padded.
+		/// \throws EndOfStream error (a compile error in a constant expression)
+		constexpr void writePadding(std::uint8_t value, std::size_t size)
+		{
+			this->internalCheck(size);
+			for (std::size_t i = 0; i < size; ++i)
+				this->binary[this->position++] = value;
+		}
+
+		/// \brief Writes binary data.
+		///
+		/// \param[in] in_binary The binary data to write.
+		/// \param[in] in_size The size of the binary data.
+		/// \throws EndOfStream error (a compile error in a constant expression)
+		constexpr void writeAligned(const std::uint8_t *in_binary, std::size_t in_size)
+		{
+			this->internalCheck(in_size);
+			for (std::size_t i = 0; i < in_size; ++i)
+				this->binary[this->position++] = in_binary[i];
+		}
+
+		/// \brief Retrieves the number of bytes written.
+		///
+		/// \return The resulting value.
+		constexpr std::size_t getNumOfBytesWritten() const
+		{
+			return this->position;
+		}
+
+		/// \brief Retrieves the whole fixed-capacity array (bytes past the written ones are zero).
+		///
+		/// \return A reference to the array.
+		constexpr const std::array<std::uint8_t, N> &getBinary() const
+		{
+			return this->binary;
+		}
+
+		/// \brief Copies the written bytes into an array of exactly that size.
+		///
+		/// \tparam M The number of bytes written.
+		///
+		/// \return The resulting array.
+		/// \throws std::invalid_argument if M is not the number of bytes written (a compile error in a constant expression).
+		template <std::size_t M>
+		constexpr std::array<std::uint8_t, M> toArray() const
+		{
+			if (M != this->position)
+				throw std::invalid_argument("Attempted to copy a fixed writer into an array that does not match the number of bytes written.");
+			std::array<std::uint8_t, M> result{};
+			for (std::size_t i = 0; i < M; ++i)
+				result[i] = this->binary[i];
+			return result;
+		}
+
+		/// \brief Retrieves a view of the written bytes.
+		///
+		/// \return The resulting view.
+		constexpr BufferView view() const
+		{
+			return BufferView(this->binary.data(), this->position);
+		}
+
+	private:
+		std::array<std::uint8_t, N> binary;
+		std::size_t position;
+
+		constexpr void internalCheck(std::size_t size) const
+		{
+			if (size > N - this->position)
+				throw exceptions::EndOfStream("Attempted to write past the capacity of a fixed writer.");
+		}
+
+		constexpr void internalWriteChars(std::string_view value)
+		{
+			this->internalCheck(value.size());
+			for (char character : value)
+				this->binary[this->position++] = static_cast<std::uint8_t>(character);
+		}
+	};
+}
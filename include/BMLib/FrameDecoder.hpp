@@ -0,0 +1,87 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Buffer.hpp"
+#include "BufferView.hpp"
+#include "exceptions/FrameTooBig.hpp"
+#include "exceptions/VarIntTooBig.hpp"
+#include <cstdint>
+#include <optional>
+
+namespace BMLib
+{
+	/// The FrameDecoder class.
+	/// Accumulates received chunks and splits them into frames prefixed with their varint length.
+	///
+	/// Frames are handed out as views into the internal buffer, which stay valid until the next feed() or clear().
+	/// Consumed bytes are compacted lazily, only once they outweigh the unconsumed ones,
+	/// so every received byte is moved at most a constant number of times.
+	class FrameDecoder
+	{
+	public:
+		static constexpr std::size_t DEFAULT_MAX_FRAME_SIZE = 2 * 1024 * 1024;
+
+		/// \brief Initializes a new FrameDecoder instance.
+		///
+		/// \param[in] max_frame_size The largest frame size accepted.
+		explicit FrameDecoder(std::size_t max_frame_size = DEFAULT_MAX_FRAME_SIZE);
+
+		FrameDecoder(const FrameDecoder &) = delete;
+		FrameDecoder &operator=(const FrameDecoder &) = delete;
+
+		/// \brief Appends a received chunk.
+		/// This invalidates the frames handed out before.
+		///
+		/// \param[in] data The received bytes.
+		/// \param[in] size The number of received bytes.
+		void feed(const std::uint8_t *data, std::size_t size);
+
+		/// \brief Peeks the size of the next frame without consuming anything.
+		///
+		/// \return The frame size, or nullopt if the length prefix was not completely received yet.
+		/// \throws VarIntTooBig error if the length prefix is malformed.
+		/// \throws FrameTooBig error if the frame is larger than the maximum frame size.
+		std::optional<std::uint32_t> peekFrameSize() const;
+
+		/// \brief Retrieves the next complete frame.
+		///
+		/// \param[out] frame The view of the frame payload (without the length prefix).
+		///
+		/// \return Whether a complete frame was available.
+		/// \throws VarIntTooBig error if the length prefix is malformed.
+		/// \throws FrameTooBig error if the frame is larger than the maximum frame size.
+		bool next(BufferView &frame);
+
+		/// \brief Retrieves the number of received bytes that were not handed out yet.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfBytesBuffered() const;
+
+		/// \brief Drops every buffered byte.
+		void clear();
+
+	private:
+		Buffer buffer;
+		std::size_t begin;
+		std::size_t max_frame_size;
+
+		bool internalPeek(std::uint32_t &frame_size, std::size_t &prefix_size) const;
+		void internalCompact();
+	};
+}
@@ -0,0 +1,269 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "BinaryStream.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace BMLib
+{
+	/// The shared layout of the Gorilla XOR encoding for a floating-point type.
+	///
+	/// Every value after the first one is XOR-ed with its predecessor and written as:
+	/// - `0` if the XOR is zero (the value repeated).
+	/// - `10` followed by the meaningful bits if they fit inside the previous leading/trailing zero window.
+	/// - `11` followed by the leading zero count, the meaningful bit count minus one and the meaningful bits.
+	///
+	/// \tparam T float or double.
+	template <typename T>
+	struct GorillaTraits
+	{
+		static_assert(std::is_floating_point_v<T> && (sizeof(T) == 4 || sizeof(T) == 8), "Gorilla encoding only supports float and double.");
+
+		using bits_type = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+
+		// the number of bits in a value.
+		static constexpr std::size_t VALUE_BITS = sizeof(T) << 3;
+		// the number of bits used to store the leading zero count.
+		static constexpr std::size_t LEADING_BITS = sizeof(T) == 8 ? 5 : 4;
+		// the number of bits used to store the meaningful bit count minus one.
+		static constexpr std::size_t LENGTH_BITS = sizeof(T) == 8 ? 6 : 5;
+		// the largest leading zero count that can be stored.
+		static constexpr std::size_t MAX_LEADING = (1 << LEADING_BITS) - 1;
+
+		static bits_type toBits(T value)
+		{
+			bits_type bits;
+			std::memcpy(&bits, &value, sizeof(T));
+			return bits;
+		}
+
+		static T fromBits(bits_type bits)
+		{
+			T value;
+			std::memcpy(&value, &bits, sizeof(T));
+			return value;
+		}
+
+		static std::size_t countLeadingZeros(bits_type value)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			if constexpr (sizeof(T) == 8)
+				return static_cast<std::size_t>(__builtin_clzll(value));
+			else
+				return static_cast<std::size_t>(__builtin_clz(value));
+#else
+			std::size_t count = 0;
+			for (bits_type mask = bits_type(1) << (VALUE_BITS - 1); (value & mask) == 0; mask >>= 1)
+				++count;
+			return count;
+#endif
+		}
+
+		static std::size_t countTrailingZeros(bits_type value)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			if constexpr (sizeof(T) == 8)
+				return static_cast<std::size_t>(__builtin_ctzll(value));
+			else
+				return static_cast<std::size_t>(__builtin_ctz(value));
+#else
+			std::size_t count = 0;
+			for (; (value & 1) == 0; value >>= 1)
+				++count;
+			return count;
+#endif
+		}
+	};
+
+	/// The GorillaEncoder class.
+	/// Writes a series of floating-point samples into a stream using the bit writer.
+	/// The bit writer must not be shared with other bit writes until finish() is called.
+	///
+	/// \tparam T float or double.
+	template <typename T>
+	class GorillaEncoder
+	{
+	public:
+		using traits = GorillaTraits<T>;
+		using bits_type = typename traits::bits_type;
+
+		/// \brief Initializes a new GorillaEncoder instance.
+		///
+		/// \param[in] stream The stream to write the series into.
+		explicit GorillaEncoder(BinaryStream *stream)
+			: stream(stream), previous(0), leading(0), trailing(0), has_previous(false), has_window(false)
+		{
+		}
+
+		/// \brief Writes the next sample of the series.
+		///
+		/// \param[in] value The value to write (the exact bit pattern is kept, NaN payloads included).
+		void write(T value)
+		{
+			bits_type bits = traits::toBits(value);
+			if (!this->has_previous) {
+				this->stream->writeBits<bits_type>(bits, traits::VALUE_BITS);
+				this->previous = bits;
+				this->has_previous = true;
+				return;
+			}
+
+			bits_type xored = bits ^ this->previous;
+			this->previous = bits;
+			if (xored == 0) {
+				this->stream->writeBit(false);
+				return;
+			}
+			this->stream->writeBit(true);
+
+			std::size_t curr_leading = std::min(traits::countLeadingZeros(xored), traits::MAX_LEADING);
+			std::size_t curr_trailing = traits::countTrailingZeros(xored);
+			if (this->has_window && curr_leading >= this->leading && curr_trailing >= this->trailing) {
+				this->stream->writeBit(false);
+				this->stream->writeBits<bits_type>(xored >> this->trailing, traits::VALUE_BITS - this->leading - this->trailing);
+				return;
+			}
+
+			std::size_t significant = traits::VALUE_BITS - curr_leading - curr_trailing;
+			this->stream->writeBit(true);
+			this->stream->writeBits<bits_type>(curr_leading, traits::LEADING_BITS);
+			this->stream->writeBits<bits_type>(significant - 1, traits::LENGTH_BITS);
+			this->stream->writeBits<bits_type>(xored >> curr_trailing, significant);
+			this->leading = curr_leading;
+			this->trailing = curr_trailing;
+			this->has_window = true;
+		}
+
+		/// \brief Flushes the pending bits of the series and resets the encoder
+		/// so the next written value starts a new series.
+		void finish()
+		{
+			this->stream->flushBitWriter();
+			this->previous = 0;
+			this->leading = this->trailing = 0;
+			this->has_previous = this->has_window = false;
+		}
+
+		/// \brief Writes an array of samples as a single series prefixed with its varint length.
+		///
+		/// \param[in] stream The stream to write into.
+		/// \param[in] values The samples to write.
+		/// \param[in] count The number of samples.
+		static void writeArray(BinaryStream *stream, const T *values, std::size_t count)
+		{
+			stream->writeVarInt<std::uint32_t>(static_cast<std::uint32_t>(count));
+			GorillaEncoder<T> encoder(stream);
+			for (std::size_t i = 0; i < count; ++i)
+				encoder.write(values[i]);
+			encoder.finish();
+		}
+
+	private:
+		BinaryStream *stream;
+		bits_type previous;
+		std::size_t leading;
+		std::size_t trailing;
+		bool has_previous;
+		bool has_window;
+	};
+
+	/// The GorillaDecoder class.
+	/// Reads a series written by GorillaEncoder using the bit reader.
+	///
+	/// \tparam T float or double.
+	template <typename T>
+	class GorillaDecoder
+	{
+	public:
+		using traits = GorillaTraits<T>;
+		using bits_type = typename traits::bits_type;
+
+		/// \brief Initializes a new GorillaDecoder instance.
+		///
+		/// \param[in] stream The stream to read the series from.
+		explicit GorillaDecoder(BinaryStream *stream)
+			: stream(stream), previous(0), leading(0), trailing(0), has_previous(false)
+		{
+		}
+
+		/// \brief Reads the next sample of the series.
+		///
+		/// \return The sample with the exact bit pattern it was written with.
+		/// \throws EndOfStream error
+		T read()
+		{
+			if (!this->has_previous) {
+				this->previous = this->stream->readBits<bits_type>(traits::VALUE_BITS);
+				this->has_previous = true;
+				return traits::fromBits(this->previous);
+			}
+
+			if (!this->stream->readBit())
+				return traits::fromBits(this->previous);
+
+			if (this->stream->readBit()) {
+				this->leading = this->stream->readBits<std::size_t>(traits::LEADING_BITS);
+				std::size_t significant = this->stream->readBits<std::size_t>(traits::LENGTH_BITS) + 1;
+				this->trailing = traits::VALUE_BITS - this->leading - significant;
+			}
+			bits_type xored = this->stream->readBits<bits_type>(traits::VALUE_BITS - this->leading - this->trailing);
+			this->previous ^= xored << this->trailing;
+			return traits::fromBits(this->previous);
+		}
+
+		/// \brief Drops the remaining bits of the current octet and resets the decoder
+		/// so the next read value starts a new series.
+		void finish()
+		{
+			this->stream->resetBitReader();
+			this->previous = 0;
+			this->leading = this->trailing = 0;
+			this->has_previous = false;
+		}
+
+		/// \brief Reads an array of samples written by GorillaEncoder::writeArray.
+		///
+		/// \param[in] stream The stream to read from.
+		///
+		/// \return The decoded samples.
+		/// \throws EndOfStream error
+		static std::vector<T> readArray(BinaryStream *stream)
+		{
+			std::uint32_t count = stream->readVarInt<std::uint32_t>();
+			std::vector<T> result;
+			result.reserve(count);
+			GorillaDecoder<T> decoder(stream);
+			for (std::uint32_t i = 0; i < count; ++i)
+				result.push_back(decoder.read());
+			decoder.finish();
+			return result;
+		}
+
+	private:
+		BinaryStream *stream;
+		bits_type previous;
+		std::size_t leading;
+		std::size_t trailing;
+		bool has_previous;
+	};
+}
@@ -0,0 +1,56 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BMLib::encoding
+{
+	/// \brief Widens packed 24-bit unsigned integers into 32-bit integers.
+	///
+	/// \param[in] in The packed integers (count * 3 bytes).
+	/// \param[out] out The widened integers (count values).
+	/// \param[in] count The number of integers.
+	/// \param[in] big_endian Whether the packed integers use big endian byte order.
+	void decodeUInt24Array(const std::uint8_t *in, std::uint32_t *out, std::size_t count, bool big_endian);
+
+	/// \brief Widens packed 24-bit signed integers into sign extended 32-bit integers.
+	///
+	/// \param[in] in The packed integers (count * 3 bytes).
+	/// \param[out] out The widened integers (count values).
+	/// \param[in] count The number of integers.
+	/// \param[in] big_endian Whether the packed integers use big endian byte order.
+	void decodeInt24Array(const std::uint8_t *in, std::int32_t *out, std::size_t count, bool big_endian);
+
+	/// \brief Narrows 32-bit unsigned integers into packed 24-bit integers (the top byte is dropped).
+	///
+	/// \param[in] in The integers (count values).
+	/// \param[out] out The packed integers (count * 3 bytes).
+	/// \param[in] count The number of integers.
+	/// \param[in] big_endian Whether to use big endian byte order.
+	void encodeUInt24Array(const std::uint32_t *in, std::uint8_t *out, std::size_t count, bool big_endian);
+
+	/// \brief Narrows 32-bit signed integers into packed 24-bit integers (the top byte is dropped).
+	///
+	/// \param[in] in The integers (count values).
+	/// \param[out] out The packed integers (count * 3 bytes).
+	/// \param[in] count The number of integers.
+	/// \param[in] big_endian Whether to use big endian byte order.
+	void encodeInt24Array(const std::int32_t *in, std::uint8_t *out, std::size_t count, bool big_endian);
+}
@@ -30,21 +30,17 @@ namespace BMLib
     {
         std::uint8_t bytes[3];
 
-        uint24_t(std::uint8_t b0, std::uint8_t b1, std::uint8_t b2)
+        constexpr uint24_t(std::uint8_t b0, std::uint8_t b1, std::uint8_t b2)
+            : bytes{b0, b1, b2}
         {
-            bytes[0] = b0;
-            bytes[1] = b1;
-            bytes[2] = b2;
         }
 
-        uint24_t(std::uint32_t value = 0)
+        constexpr uint24_t(std::uint32_t value = 0)
+            : bytes{static_cast<std::uint8_t>(value >> 16), static_cast<std::uint8_t>(value >> 8), static_cast<std::uint8_t>(value)}
         {
-            bytes[0] = static_cast<std::uint8_t>(value >> 16);
-            bytes[1] = static_cast<std::uint8_t>(value >> 8);
-            bytes[2] = static_cast<std::uint8_t>(value);
         }
 
-        operator std::uint32_t() const
+        constexpr operator std::uint32_t() const
         {
             std::uint32_t value = 0;
             value |= bytes[0] << 16;
@@ -215,27 +211,24 @@ namespace BMLib
     {
         std::int8_t bytes[3];
 
-        int24_t(std::int8_t b0, std::int8_t b1, std::int8_t b2)
+        constexpr int24_t(std::int8_t b0, std::int8_t b1, std::int8_t b2)
+            : bytes{b0, b1, b2}
         {
-            bytes[0] = b0;
-            bytes[1] = b1;
-            bytes[2] = b2;
         }
 
-        int24_t(std::int32_t value = 0)
+        constexpr int24_t(std::int32_t value = 0)
+            : bytes{static_cast<std::int8_t>(value >> 16), static_cast<std::int8_t>(value >> 8), static_cast<std::int8_t>(value)}
         {
-            bytes[0] = static_cast<std::int8_t>(value >> 16);
-            bytes[1] = static_cast<std::int8_t>(value >> 8);
-            bytes[2] = static_cast<std::int8_t>(value);
         }
 
-        operator std::int32_t() const
+        constexpr operator std::int32_t() const
         {
-            std::int32_t value = 0;
-            value |= bytes[0] << 16;
-            value |= bytes[1] << 8;
-            value |= bytes[2];
-            return value;
+            std::uint32_t value = 0;
+            value |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[0])) << 16;
+            value |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[1])) << 8;
+            value |= static_cast<std::uint8_t>(bytes[2]);
+            // flipping the sign bit then subtracting it sign extends from 24 bits without relying on shifts of negative values.
+            return static_cast<std::int32_t>(value ^ 0x800000) - 0x800000;
         }
 
         int24_t &operator=(std::int32_t rhs)
@@ -0,0 +1,305 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "BinaryStream.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace BMLib
+{
+	/// The field definitions shared by eager (readRecord) and lazy (LazyRecord) decoding.
+	/// A field is any type with a value_type and static read/skip functions taking the stream,
+	/// so protocol specific fields can be added next to these.
+	namespace fields
+	{
+		template <typename T, bool BigEndian = true>
+		struct Fixed
+		{
+			using value_type = T;
+
+			template <typename Stream>
+			static T read(Stream *stream)
+			{
+				return stream->template read<T>(BigEndian);
+			}
+
+			template <typename Stream>
+			static void skip(Stream *stream)
+			{
+				stream->template skip<T>();
+			}
+		};
+
+		template <typename T, bool BigEndian = true>
+		struct Float
+		{
+			using value_type = T;
+
+			template <typename Stream>
+			static T read(Stream *stream)
+			{
+				return stream->template readFloat<T>(BigEndian);
+			}
+
+			template <typename Stream>
+			static void skip(Stream *stream)
+			{
+				stream->template skip<T>();
+			}
+		};
+
+		template <typename T = std::uint32_t>
+		struct VarInt
+		{
+			using value_type = T;
+
+			template <typename Stream>
+			static T read(Stream *stream)
+			{
+				return stream->template readVarInt<T>();
+			}
+
+			template <typename Stream>
+			static void skip(Stream *stream)
+			{
+				stream->template skipVarInt<T>();
+			}
+		};
+
+		template <typename T = std::int32_t>
+		struct ZigZag
+		{
+			using value_type = T;
+
+			template <typename Stream>
+			static T read(Stream *stream)
+			{
+				return stream->template readZigZag<T>();
+			}
+
+			template <typename Stream>
+			static void skip(Stream *stream)
+			{
+				stream->template skipZigZag<T>();
+			}
+		};
+
+		template <typename T, bool BigEndian = true>
+		struct String
+		{
+			using value_type = std::string;
+
+			template <typename Stream>
+			static std::string read(Stream *stream)
+			{
+				return stream->template readString<T>(BigEndian);
+			}
+
+			template <typename Stream>
+			static void skip(Stream *stream)
+			{
+				stream->template skipString<T>(BigEndian);
+			}
+		};
+
+		template <typename T = std::uint32_t>
+		struct StringVarInt
+		{
+			using value_type = std::string;
+
+			template <typename Stream>
+			static std::string read(Stream *stream)
+			{
+				return stream->template readStringVarInt<T>();
+			}
+
+			template <typename Stream>
+			static void skip(Stream *stream)
+			{
+				stream->template skipStringVarInt<T>();
+			}
+		};
+
+		/// A varint length prefixed byte string read as a view, valid until the buffer is modified.
+		template <typename T = std::uint32_t>
+		struct BytesVarInt
+		{
+			using value_type = BufferView;
+
+			template <typename Stream>
+			static BufferView read(Stream *stream)
+			{
+				return stream->readView(stream->template readVarInt<T>());
+			}
+
+			template <typename Stream>
+			static void skip(Stream *stream)
+			{
+				stream->template skipStringVarInt<T>();
+			}
+		};
+
+		/// A field written with writeOptional.
+		template <typename Field>
+		struct Optional
+		{
+			using value_type = std::optional<typename Field::value_type>;
+
+			template <typename Stream>
+			static value_type read(Stream *stream)
+			{
+				if (!stream->template read<bool>())
+					return std::nullopt;
+				return Field::read(stream);
+			}
+
+			template <typename Stream>
+			static void skip(Stream *stream)
+			{
+				stream->skipOptional([](Stream *source) { Field::skip(source); });
+			}
+		};
+	}
+
+	/// \brief Decodes every field of a record in order.
+	///
+	/// \param[in] stream The stream to read the record from.
+	///
+	/// \return The decoded values.
+	/// \throws what the field reads throw
+	template <typename... Fields, typename Stream>
+	std::tuple<typename Fields::value_type...> readRecord(Stream *stream)
+	{
+		// the braced initializer evaluates the reads from left to right.
+		return std::tuple<typename Fields::value_type...>{Fields::read(stream)...};
+	}
+
+	/// The BasicLazyRecord class.
+	/// Scans a record once, skipping every field and keeping its offset in an inline table,
+	/// and decodes a field only when it is first accessed. The stream and its buffer must outlive the record
+	/// and stay unmodified.
+	///
+	/// \tparam Stream The stream type (BinaryStream or any BasicBinaryStream policy combination).
+	/// \tparam Fields The field definitions (see the fields namespace).
+	template <typename Stream, typename... Fields>
+	class BasicLazyRecord
+	{
+	public:
+		static constexpr std::size_t FIELD_COUNT = sizeof...(Fields);
+
+		template <std::size_t I>
+		using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+		template <std::size_t I>
+		using value_type = typename field_type<I>::value_type;
+
+		/// \brief Initializes a new LazyRecord instance by scanning the record at the stream position.
+		/// The stream is left after the record.
+		///
+		/// \param[in] stream The stream to read the record from.
+		/// \throws what the field skips throw
+		explicit BasicLazyRecord(Stream *stream)
+			: stream(stream), begin(stream->getNumOfBytesRead())
+		{
+			[[maybe_unused]] std::size_t index = 0;
+			((this->offsets[index++] = stream->getNumOfBytesRead(), Fields::skip(stream)), ...);
+			this->end = stream->getNumOfBytesRead();
+		}
+
+		/// \brief Retrieves a field, decoding it on the first access.
+		///
+		/// \tparam I The index of the field.
+		///
+		/// \return The decoded value, valid as long as the record.
+		/// \throws what the field read throws
+		template <std::size_t I>
+		const value_type<I> &get()
+		{
+			std::optional<value_type<I>> &cached = std::get<I>(this->values);
+			if (!cached) {
+				std::size_t position = this->stream->getNumOfBytesRead();
+				this->stream->setPosition(this->offsets[I]);
+				try {
+					cached.emplace(field_type<I>::read(this->stream));
+				} catch (...) {
+					this->stream->setPosition(position);
+					throw;
+				}
+				this->stream->setPosition(position);
+			}
+			return *cached;
+		}
+
+		/// \brief Checks if a field was already decoded.
+		///
+		/// \tparam I The index of the field.
+		///
+		/// \return Condition of the action.
+		template <std::size_t I>
+		bool isDecoded() const
+		{
+			return std::get<I>(this->values).has_value();
+		}
+
+		/// \brief Retrieves the stream position of a field.
+		///
+		/// \tparam I The index of the field.
+		///
+		/// \return The resulting value.
+		template <std::size_t I>
+		std::size_t getOffset() const
+		{
+			return this->offsets[I];
+		}
+
+		/// \brief Retrieves the number of bytes the record spans.
+		///
+		/// \return The resulting value.
+		std::size_t getSize() const
+		{
+			return this->end - this->begin;
+		}
+
+	private:
+		Stream *stream;
+		std::size_t begin;
+		std::size_t end;
+		std::array<std::size_t, FIELD_COUNT> offsets;
+		std::tuple<std::optional<typename Fields::value_type>...> values;
+	};
+
+	template <typename... Fields>
+	using LazyRecord = BasicLazyRecord<BinaryStream, Fields...>;
+
+	/// \brief Scans the record at the stream position into a BasicLazyRecord of the stream type.
+	///
+	/// \param[in] stream The stream to read the record from.
+	///
+	/// \return The scanned record.
+	/// \throws what the field skips throw
+	template <typename... Fields, typename Stream>
+	BasicLazyRecord<Stream, Fields...> scanRecord(Stream *stream)
+	{
+		return BasicLazyRecord<Stream, Fields...>(stream);
+	}
+}
@@ -0,0 +1,595 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "BinaryStream.hpp"
+#include "exceptions/InvalidWireFormat.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace BMLib::protobuf
+{
+	/// The wire types of the Protocol Buffers encoding, stored in the low 3 bits of every tag.
+	enum class WireType : std::uint8_t
+	{
+		VarInt = 0,
+		Fixed64 = 1,
+		LengthDelimited = 2,
+		StartGroup = 3,
+		EndGroup = 4,
+		Fixed32 = 5
+	};
+
+	namespace detail
+	{
+		// int32/int64/enum values are sign extended to 64 bits, so negative values always take 10 bytes.
+		template <typename T>
+		constexpr std::uint64_t toVarInt(T value)
+		{
+			if constexpr (std::is_signed_v<T>)
+				return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+			else
+				return static_cast<std::uint64_t>(value);
+		}
+
+		template <typename T>
+		constexpr auto toFixed(T value)
+		{
+			if constexpr (std::is_floating_point_v<T>) {
+				std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t> bits = 0;
+				std::memcpy(&bits, &value, sizeof(T));
+				return bits;
+			} else
+				return static_cast<std::make_unsigned_t<T>>(value);
+		}
+
+		template <typename T, typename Bits>
+		constexpr T fromFixed(Bits bits)
+		{
+			if constexpr (std::is_floating_point_v<T>) {
+				T value;
+				std::memcpy(&value, &bits, sizeof(T));
+				return value;
+			} else
+				return static_cast<T>(bits);
+		}
+	}
+
+	/// The ProtoWriter class.
+	/// Writes fields in the Protocol Buffers wire format, byte compatible with the protobuf runtimes.
+	/// Fields are written in call order, so the caller decides the field order and which defaults to omit.
+	class ProtoWriter
+	{
+	public:
+		/// \brief Initializes a new ProtoWriter instance.
+		///
+		/// \param[in] stream The stream to write the fields into.
+		explicit ProtoWriter(BinaryStream *stream) : stream(stream)
+		{
+		}
+
+		/// \brief Writes a field tag.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] wire_type The wire type of the field value.
+		void writeTag(std::uint32_t field, WireType wire_type)
+		{
+			this->stream->writeVarInt<std::uint32_t>((field << 3) | static_cast<std::uint32_t>(wire_type));
+		}
+
+		/// \brief Writes a uint32 field.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		void writeUInt32(std::uint32_t field, std::uint32_t value)
+		{
+			this->writeTag(field, WireType::VarInt);
+			this->stream->writeVarInt<std::uint32_t>(value);
+		}
+
+		/// \brief Writes a uint64 field.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		void writeUInt64(std::uint32_t field, std::uint64_t value)
+		{
+			this->writeTag(field, WireType::VarInt);
+			this->stream->writeVarInt<std::uint64_t>(value);
+		}
+
+		/// \brief Writes an int32 (or enum) field, negative values take 10 bytes like in protobuf.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		void writeInt32(std::uint32_t field, std::int32_t value)
+		{
+			this->writeTag(field, WireType::VarInt);
+			this->stream->writeVarInt<std::uint64_t>(detail::toVarInt(value));
+		}
+
+		/// \brief Writes an int64 field, negative values take 10 bytes like in protobuf.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		void writeInt64(std::uint32_t field, std::int64_t value)
+		{
+			this->writeTag(field, WireType::VarInt);
+			this->stream->writeVarInt<std::uint64_t>(detail::toVarInt(value));
+		}
+
+		/// \brief Writes a sint32 (zigzag) field.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		void writeSInt32(std::uint32_t field, std::int32_t value)
+		{
+			this->writeTag(field, WireType::VarInt);
+			this->stream->writeZigZag<std::int32_t>(value);
+		}
+
+		/// \brief Writes a sint64 (zigzag) field.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		void writeSInt64(std::uint32_t field, std::int64_t value)
+		{
+			this->writeTag(field, WireType::VarInt);
+			this->stream->writeZigZag<std::int64_t>(value);
+		}
+
+		/// \brief Writes a bool field.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		void writeBool(std::uint32_t field, bool value)
+		{
+			this->writeTag(field, WireType::VarInt);
+			this->stream->write<std::uint8_t>(value ? 1 : 0);
+		}
+
+		/// \brief Writes a fixed32, sfixed32 or float field (little endian like in protobuf).
+		///
+		/// \tparam T std::uint32_t, std::int32_t or float.
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		template <typename T>
+		std::enable_if_t<sizeof(T) == 4 && std::is_arithmetic_v<T>> writeFixed32(std::uint32_t field, T value)
+		{
+			this->writeTag(field, WireType::Fixed32);
+			this->stream->write<std::uint32_t>(detail::toFixed(value), false);
+		}
+
+		/// \brief Writes a fixed64, sfixed64 or double field (little endian like in protobuf).
+		///
+		/// \tparam T std::uint64_t, std::int64_t or double.
+		/// \param[in] field The field number.
+		/// \param[in] value The value to write.
+		template <typename T>
+		std::enable_if_t<sizeof(T) == 8 && std::is_arithmetic_v<T>> writeFixed64(std::uint32_t field, T value)
+		{
+			this->writeTag(field, WireType::Fixed64);
+			this->stream->write<std::uint64_t>(detail::toFixed(value), false);
+		}
+
+		/// \brief Writes a bytes field.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The bytes to write.
+		void writeBytes(std::uint32_t field, BufferView value)
+		{
+			this->writeTag(field, WireType::LengthDelimited);
+			this->stream->writeVarInt<std::uint64_t>(value.size);
+			if (!value.empty())
+				this->stream->getBuffer()->writeAligned(value.binary, value.size);
+		}
+
+		/// \brief Writes a string field.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] value The string to write (written as is, it is not checked to be UTF-8).
+		void writeString(std::uint32_t field, const std::string &value)
+		{
+			this->writeBytes(field, BufferView(reinterpret_cast<const std::uint8_t *>(value.data()), value.size()));
+		}
+
+		/// \brief Starts an embedded message field, its length is backpatched by endMessage.
+		/// Embedded messages can be nested.
+		///
+		/// \param[in] field The field number.
+		void beginMessage(std::uint32_t field)
+		{
+			this->writeTag(field, WireType::LengthDelimited);
+			this->stream->beginLengthPrefixedVarInt<std::uint32_t>();
+		}
+
+		/// \brief Ends the innermost embedded message started by beginMessage.
+		///
+		/// \return The size of the embedded message.
+		std::size_t endMessage()
+		{
+			return this->stream->endLengthPrefixed();
+		}
+
+		/// \brief Writes a packed repeated uint32, uint64, int32, int64, enum or bool field.
+		/// The length is computed up front and the varints are encoded straight into the buffer.
+		/// Nothing is written for an empty field, like in protobuf.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] values The values to write.
+		/// \param[in] count The number of values.
+		template <typename T>
+		std::enable_if_t<std::is_integral_v<T>> writePackedVarInt(std::uint32_t field, const T *values, std::size_t count)
+		{
+			this->internalWritePacked(field, values, count, [](T value) { return detail::toVarInt(value); });
+		}
+
+		/// \brief Writes a packed repeated sint32 or sint64 field (see writePackedVarInt).
+		///
+		/// \param[in] field The field number.
+		/// \param[in] values The values to write.
+		/// \param[in] count The number of values.
+		template <typename T>
+		std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>> writePackedZigZag(std::uint32_t field, const T *values, std::size_t count)
+		{
+			this->internalWritePacked(field, values, count, [](T value) { return static_cast<std::uint64_t>(encoding::encodeZigZag<T>(value)); });
+		}
+
+		/// \brief Writes a packed repeated fixed32, fixed64, sfixed32, sfixed64, float or double field.
+		/// Nothing is written for an empty field, like in protobuf.
+		///
+		/// \param[in] field The field number.
+		/// \param[in] values The values to write.
+		/// \param[in] count The number of values.
+		template <typename T>
+		std::enable_if_t<std::is_arithmetic_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)> writePackedFixed(std::uint32_t field, const T *values, std::size_t count)
+		{
+			if (count == 0)
+				return;
+			this->writeTag(field, WireType::LengthDelimited);
+			this->stream->writeVarInt<std::uint64_t>(count * sizeof(T));
+			std::uint8_t *out = this->stream->getBuffer()->writeUninitialized(count * sizeof(T));
+			for (std::size_t i = 0; i < count; ++i)
+				encoding::encodeFixed(detail::toFixed(values[i]), out + i * sizeof(T), false);
+		}
+
+	private:
+		BinaryStream *stream;
+
+		template <typename T, typename F>
+		void internalWritePacked(std::uint32_t field, const T *values, std::size_t count, F &&to_varint)
+		{
+			if (count == 0)
+				return;
+			std::size_t size = 0;
+			for (std::size_t i = 0; i < count; ++i)
+				size += encoding::varIntSize<std::uint64_t>(to_varint(values[i]));
+			this->writeTag(field, WireType::LengthDelimited);
+			this->stream->writeVarInt<std::uint64_t>(size);
+			std::uint8_t *out = this->stream->getBuffer()->writeUninitialized(size);
+			for (std::size_t i = 0; i < count; ++i)
+				out += encoding::encodeVarInt<std::uint64_t>(to_varint(values[i]), out);
+		}
+	};
+
+	/// The ProtoReader class.
+	/// Reads fields in the Protocol Buffers wire format from a stream, up to the end of the message.
+	///
+	/// Call next() to read each tag, then one of the read functions matching the field, or skip()
+	/// for unknown fields. Values are decoded like protobuf does (int32 from a 64-bit varint is truncated).
+	class ProtoReader
+	{
+	public:
+		// the deepest group nesting skip() accepts, the same limit protobuf uses.
+		static constexpr std::size_t MAX_GROUP_DEPTH = 100;
+
+		/// \brief Initializes a new ProtoReader instance that reads until the end of the buffer.
+		///
+		/// \param[in] stream The stream to read the fields from.
+		explicit ProtoReader(BinaryStream *stream)
+			: ProtoReader(stream, stream->getBuffer()->size)
+		{
+		}
+
+		/// \brief Initializes a new ProtoReader instance.
+		///
+		/// \param[in] stream The stream to read the fields from.
+		/// \param[in] end The position the message ends at.
+		ProtoReader(BinaryStream *stream, std::size_t end)
+			: stream(stream), end(end), field(0), wire_type(WireType::VarInt)
+		{
+		}
+
+		/// \brief Reads the next field tag.
+		///
+		/// \return False once the end of the message was reached.
+		/// \throws InvalidWireFormat error if the tag is malformed or a field crossed the end of the message.
+		bool next()
+		{
+			std::size_t position = this->stream->getNumOfBytesRead();
+			if (position >= this->end) {
+				if (position > this->end)
+					throw exceptions::InvalidWireFormat("Attempted to read a field that ends " + std::to_string(position - this->end) + " bytes past the end of its message.");
+				return false;
+			}
+			std::uint32_t tag = this->stream->readVarInt<std::uint32_t>();
+			this->field = tag >> 3;
+			this->wire_type = static_cast<WireType>(tag & 7);
+			if (this->field == 0 || (tag & 7) > static_cast<std::uint32_t>(WireType::Fixed32))
+				throw exceptions::InvalidWireFormat("Attempted to read a tag with field number " + std::to_string(this->field) + " and wire type " + std::to_string(tag & 7) + ".");
+			return true;
+		}
+
+		/// \brief Retrieves the field number of the current field.
+		///
+		/// \return The resulting value.
+		std::uint32_t getField() const
+		{
+			return this->field;
+		}
+
+		/// \brief Retrieves the wire type of the current field.
+		///
+		/// \return The resulting value.
+		WireType getWireType() const
+		{
+			return this->wire_type;
+		}
+
+		/// \brief Reads a uint32 field, the varint is truncated to 32 bits like in protobuf.
+		///
+		/// \return The resulting value.
+		std::uint32_t readUInt32()
+		{
+			return static_cast<std::uint32_t>(this->stream->readVarInt<std::uint64_t>());
+		}
+
+		/// \brief Reads a uint64 field.
+		///
+		/// \return The resulting value.
+		std::uint64_t readUInt64()
+		{
+			return this->stream->readVarInt<std::uint64_t>();
+		}
+
+		/// \brief Reads an int32 (or enum) field, the varint is truncated to 32 bits like in protobuf.
+		///
+		/// \return The resulting value.
+		std::int32_t readInt32()
+		{
+			return static_cast<std::int32_t>(this->stream->readVarInt<std::uint64_t>());
+		}
+
+		/// \brief Reads an int64 field.
+		///
+		/// \return The resulting value.
+		std::int64_t readInt64()
+		{
+			return static_cast<std::int64_t>(this->stream->readVarInt<std::uint64_t>());
+		}
+
+		/// \brief Reads a sint32 (zigzag) field.
+		///
+		/// \return The resulting value.
+		std::int32_t readSInt32()
+		{
+			return encoding::decodeZigZag<std::int32_t>(this->readUInt32());
+		}
+
+		/// \brief Reads a sint64 (zigzag) field.
+		///
+		/// \return The resulting value.
+		std::int64_t readSInt64()
+		{
+			return encoding::decodeZigZag<std::int64_t>(this->readUInt64());
+		}
+
+		/// \brief Reads a bool field.
+		///
+		/// \return The resulting value.
+		bool readBool()
+		{
+			return this->stream->readVarInt<std::uint64_t>() != 0;
+		}
+
+		/// \brief Reads a fixed32, sfixed32 or float field.
+		///
+		/// \tparam T std::uint32_t, std::int32_t or float.
+		///
+		/// \return The resulting value.
+		template <typename T>
+		std::enable_if_t<sizeof(T) == 4 && std::is_arithmetic_v<T>, T> readFixed32()
+		{
+			return detail::fromFixed<T>(this->stream->read<std::uint32_t>(false));
+		}
+
+		/// \brief Reads a fixed64, sfixed64 or double field.
+		///
+		/// \tparam T std::uint64_t, std::int64_t or double.
+		///
+		/// \return The resulting value.
+		template <typename T>
+		std::enable_if_t<sizeof(T) == 8 && std::is_arithmetic_v<T>, T> readFixed64()
+		{
+			return detail::fromFixed<T>(this->stream->read<std::uint64_t>(false));
+		}
+
+		/// \brief Reads a bytes field without copying it.
+		///
+		/// \return A view of the bytes inside the stream buffer.
+		/// \throws InvalidWireFormat error if the field crosses the end of the message.
+		BufferView readBytes()
+		{
+			return this->stream->readView(this->internalReadLength());
+		}
+
+		/// \brief Reads a string field.
+		///
+		/// \return The string copied out of the stream buffer.
+		/// \throws InvalidWireFormat error if the field crosses the end of the message.
+		std::string readString()
+		{
+			BufferView bytes = this->readBytes();
+			return std::string(reinterpret_cast<const char *>(bytes.binary), bytes.size);
+		}
+
+		/// \brief Reads an embedded message field.
+		/// The stream continues after the embedded message even if read_fields did not read all of it.
+		///
+		/// \param[in] read_fields The function that reads the fields through the ProtoReader it is given.
+		/// \throws InvalidWireFormat error if the field crosses the end of the message.
+		template <typename F>
+		void readMessage(F &&read_fields)
+		{
+			std::size_t length = this->internalReadLength();
+			std::size_t message_end = this->stream->getNumOfBytesRead() + length;
+			ProtoReader message(this->stream, message_end);
+			read_fields(message);
+			this->stream->setPosition(message_end);
+		}
+
+		/// \brief Reads a repeated uint32, uint64, int32, int64, enum or bool field into values.
+		/// Both the packed and the unpacked encodings are accepted, like in protobuf.
+		///
+		/// \param[out] values The vector the values are appended to.
+		template <typename T>
+		std::enable_if_t<std::is_integral_v<T>> readPackedVarInt(std::vector<T> &values)
+		{
+			this->internalReadPacked(values, [](std::uint64_t value) { return static_cast<T>(value); });
+		}
+
+		/// \brief Reads a repeated sint32 or sint64 field into values (see readPackedVarInt).
+		///
+		/// \param[out] values The vector the values are appended to.
+		template <typename T>
+		std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>> readPackedZigZag(std::vector<T> &values)
+		{
+			this->internalReadPacked(values, [](std::uint64_t value) { return encoding::decodeZigZag<T>(static_cast<std::make_unsigned_t<T>>(value)); });
+		}
+
+		/// \brief Reads a repeated fixed32, fixed64, sfixed32, sfixed64, float or double field into values.
+		/// Both the packed and the unpacked encodings are accepted, like in protobuf.
+		///
+		/// \param[out] values The vector the values are appended to.
+		/// \throws InvalidWireFormat error if the packed size is not a multiple of the value size.
+		template <typename T>
+		std::enable_if_t<std::is_arithmetic_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)> readPackedFixed(std::vector<T> &values)
+		{
+			using bits_type = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+			if (this->wire_type != WireType::LengthDelimited) {
+				values.push_back(detail::fromFixed<T>(this->stream->read<bits_type>(false)));
+				return;
+			}
+			BufferView bytes = this->readBytes();
+			if (bytes.size % sizeof(T) != 0)
+				throw exceptions::InvalidWireFormat("Attempted to read a packed field of " + std::to_string(bytes.size) + " bytes, which is not a multiple of " + std::to_string(sizeof(T)) + " bytes.");
+			std::size_t count = bytes.size / sizeof(T);
+			std::size_t offset = values.size();
+			values.resize(offset + count);
+			for (std::size_t i = 0; i < count; ++i)
+				values[offset + i] = detail::fromFixed<T>(encoding::decodeFixed<bits_type>(bytes.binary + i * sizeof(T), false));
+		}
+
+		/// \brief Skips the value of the current field, used for unknown fields.
+		/// Varints are skipped without decoding them and length-delimited values with a single jump.
+		/// Groups are skipped without recursion and may be nested up to MAX_GROUP_DEPTH levels, like in protobuf.
+		///
+		/// \throws InvalidWireFormat error if a group is malformed or nested too deeply, or a field crosses the end of the message.
+		void skip()
+		{
+			if (this->wire_type != WireType::StartGroup) {
+				if (this->wire_type == WireType::EndGroup)
+					throw exceptions::InvalidWireFormat("Attempted to skip the end marker of group " + std::to_string(this->field) + " without its start marker.");
+				this->internalSkipValue();
+				return;
+			}
+			// the field numbers of the open groups, innermost last.
+			std::uint32_t groups[MAX_GROUP_DEPTH];
+			std::size_t depth = 0;
+			groups[depth++] = this->field;
+			while (depth > 0) {
+				if (!this->next())
+					throw exceptions::InvalidWireFormat("Attempted to skip group " + std::to_string(groups[depth - 1]) + ", but the message ended before its end marker.");
+				if (this->wire_type == WireType::StartGroup) {
+					if (depth == MAX_GROUP_DEPTH)
+						throw exceptions::InvalidWireFormat("Attempted to skip groups nested more than " + std::to_string(MAX_GROUP_DEPTH) + " levels deep.");
+					groups[depth++] = this->field;
+				} else if (this->wire_type == WireType::EndGroup) {
+					if (this->field != groups[depth - 1])
+						throw exceptions::InvalidWireFormat("Attempted to skip group " + std::to_string(groups[depth - 1]) + ", but it was ended by the marker of group " + std::to_string(this->field) + ".");
+					--depth;
+				} else
+					this->internalSkipValue();
+			}
+		}
+
+	private:
+		BinaryStream *stream;
+		std::size_t end;
+		std::uint32_t field;
+		WireType wire_type;
+
+		void internalSkipValue()
+		{
+			switch (this->wire_type) {
+			case WireType::VarInt:
+				this->stream->skipVarInt<std::uint64_t>();
+				break;
+			case WireType::Fixed64:
+				this->stream->skip<std::uint64_t>();
+				break;
+			case WireType::Fixed32:
+				this->stream->skip<std::uint32_t>();
+				break;
+			default:
+				this->readBytes();
+				break;
+			}
+		}
+
+		std::size_t internalReadLength()
+		{
+			std::size_t length = this->stream->readVarInt<std::uint32_t>();
+			std::size_t position = this->stream->getNumOfBytesRead();
+			if (position > this->end || length > this->end - position)
+				throw exceptions::InvalidWireFormat("Attempted to read a length-delimited field of " + std::to_string(length) + " bytes, but its message ends before it.");
+			return length;
+		}
+
+		template <typename T, typename F>
+		void internalReadPacked(std::vector<T> &values, F &&from_varint)
+		{
+			if (this->wire_type != WireType::LengthDelimited) {
+				values.push_back(from_varint(this->stream->readVarInt<std::uint64_t>()));
+				return;
+			}
+			std::size_t length = this->internalReadLength();
+			std::size_t packed_end = this->stream->getNumOfBytesRead() + length;
+			// every varint ends with the only byte of it below 0x80, so counting them sizes the vector once.
+			const std::uint8_t *packed = this->stream->getBuffer()->binary + this->stream->getNumOfBytesRead();
+			values.reserve(values.size() + static_cast<std::size_t>(std::count_if(packed, packed + length, [](std::uint8_t byte) { return byte < 0x80; })));
+			while (this->stream->getNumOfBytesRead() < packed_end)
+				values.push_back(from_varint(this->stream->readVarInt<std::uint64_t>()));
+			if (this->stream->getNumOfBytesRead() != packed_end)
+				throw exceptions::InvalidWireFormat("Attempted to read a packed field, but its last varint crosses the end of the field.");
+		}
+	};
+}
@@ -0,0 +1,424 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// The resumable decoder requires C++20 coroutines (see the BINARY_STREAM_COROUTINES option).
+#ifdef __cpp_impl_coroutine
+
+#include "BinaryStream.hpp"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace BMLib
+{
+	template <typename T>
+	struct DecodeTaskResult
+	{
+		std::optional<T> value;
+
+		void return_value(T result)
+		{
+			this->value.emplace(std::move(result));
+		}
+	};
+
+	template <>
+	struct DecodeTaskResult<void>
+	{
+		void return_void()
+		{
+		}
+	};
+
+	/// The DecodeTask class.
+	/// The return type of decode coroutines that read from a ResumableReader.
+	///
+	/// The coroutine starts running as soon as it is called and suspends whenever the reader runs out of bytes.
+	/// It is resumed by ResumableReader::feed() exactly where it stopped.
+	/// A DecodeTask can also be awaited from another decode coroutine to nest decoders.
+	/// A suspended task must outlive the feeds of its reader, or the reader must be cancelled before the task is destroyed.
+	///
+	/// \tparam T The type of the decoded value.
+	template <typename T>
+	class DecodeTask
+	{
+	public:
+		struct promise_type : DecodeTaskResult<T>
+		{
+			std::exception_ptr exception;
+			std::coroutine_handle<> continuation;
+
+			DecodeTask get_return_object()
+			{
+				return DecodeTask(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			std::suspend_never initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			auto final_suspend() noexcept
+			{
+				struct FinalAwaiter
+				{
+					bool await_ready() noexcept
+					{
+						return false;
+					}
+
+					std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+					{
+						std::coroutine_handle<> continuation = handle.promise().continuation;
+						return continuation ? continuation : std::noop_coroutine();
+					}
+
+					void await_resume() noexcept
+					{
+					}
+				};
+				return FinalAwaiter{};
+			}
+
+			void unhandled_exception()
+			{
+				this->exception = std::current_exception();
+			}
+		};
+
+		DecodeTask(DecodeTask &&other) noexcept : handle(std::exchange(other.handle, nullptr))
+		{
+		}
+
+		DecodeTask &operator=(DecodeTask &&other) noexcept
+		{
+			if (this != &other) {
+				if (this->handle)
+					this->handle.destroy();
+				this->handle = std::exchange(other.handle, nullptr);
+			}
+			return *this;
+		}
+
+		DecodeTask(const DecodeTask &) = delete;
+		DecodeTask &operator=(const DecodeTask &) = delete;
+
+		/// \brief Destructor for the DecodeTask class.
+		/// This destroys the coroutine frame.
+		~DecodeTask()
+		{
+			if (this->handle)
+				this->handle.destroy();
+		}
+
+		/// \brief Checks if the coroutine finished decoding.
+		///
+		/// \return Condition of the action.
+		bool done() const
+		{
+			return this->handle && this->handle.done();
+		}
+
+		/// \brief Retrieves the decoded value of a finished coroutine.
+		///
+		/// \return The decoded value.
+		/// \throws What the coroutine threw.
+		T result()
+		{
+			promise_type &promise = this->handle.promise();
+			if (promise.exception)
+				std::rethrow_exception(promise.exception);
+			if constexpr (!std::is_void_v<T>)
+				return std::move(*promise.value);
+		}
+
+		bool await_ready() const
+		{
+			return this->handle.done();
+		}
+
+		void await_suspend(std::coroutine_handle<> awaiting)
+		{
+			this->handle.promise().continuation = awaiting;
+		}
+
+		T await_resume()
+		{
+			return this->result();
+		}
+
+	private:
+		std::coroutine_handle<promise_type> handle;
+
+		explicit DecodeTask(std::coroutine_handle<promise_type> handle) : handle(handle)
+		{
+		}
+	};
+
+	/// The ResumableReader class.
+	/// Accumulates received chunks and provides awaitable reads for decode coroutines.
+	/// Reads that run out of bytes suspend the coroutine, keeping their partial progress,
+	/// until feed() provides enough bytes to finish them.
+	class ResumableReader
+	{
+	public:
+		/// \brief Initializes a new ResumableReader instance.
+		ResumableReader();
+
+		ResumableReader(const ResumableReader &) = delete;
+		ResumableReader &operator=(const ResumableReader &) = delete;
+
+		/// \brief Appends a received chunk and resumes the waiting coroutine if its read can now finish.
+		///
+		/// \param[in] data The received bytes.
+		/// \param[in] size The number of received bytes.
+		void feed(const std::uint8_t *data, std::size_t size);
+
+		/// \brief Forgets the waiting coroutine (used before destroying a suspended DecodeTask).
+		void cancel();
+
+		/// \brief Checks if a coroutine is waiting for more bytes.
+		///
+		/// \return Condition of the action.
+		bool isWaiting() const;
+
+		/// \brief Retrieves the number of received bytes that were not read yet.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfBytesAvailable();
+
+		/// \brief Awaitable version of BinaryStream::read.
+		///
+		/// \tparam T the type that will be read.
+		/// \param[in] big_endian Whether to use big endian byte order.
+		template <typename T>
+		auto read(bool big_endian = true)
+		{
+			struct Awaiter : AwaiterBase<Awaiter>
+			{
+				bool big_endian;
+
+				bool poll()
+				{
+					return this->reader->getNumOfBytesAvailable() >= sizeof(T);
+				}
+
+				T await_resume()
+				{
+					return this->reader->stream.template read<T>(this->big_endian);
+				}
+			};
+			return Awaiter{{this}, big_endian};
+		}
+
+		/// \brief Awaitable version of BinaryStream::readFloat.
+		///
+		/// \tparam T the type that will be read.
+		/// \param[in] big_endian Whether to use big endian byte order.
+		template <typename T>
+		auto readFloat(bool big_endian = true)
+		{
+			struct Awaiter : AwaiterBase<Awaiter>
+			{
+				bool big_endian;
+
+				bool poll()
+				{
+					return this->reader->getNumOfBytesAvailable() >= sizeof(T);
+				}
+
+				T await_resume()
+				{
+					return this->reader->stream.template readFloat<T>(this->big_endian);
+				}
+			};
+			return Awaiter{{this}, big_endian};
+		}
+
+		/// \brief Awaitable version of BinaryStream::readVarInt.
+		/// The bytes that were already received are decoded before suspending, so no byte is decoded twice.
+		///
+		/// \tparam T the type that will be read.
+		template <typename T = std::uint32_t>
+		auto readVarInt()
+		{
+			struct Awaiter : AwaiterBase<Awaiter>
+			{
+				VarIntState<T> state;
+
+				bool poll()
+				{
+					return this->state.poll(this->reader);
+				}
+
+				T await_resume()
+				{
+					return this->state.get();
+				}
+			};
+			return Awaiter{{this}, {}};
+		}
+
+		/// \brief Awaitable version of BinaryStream::readZigZag.
+		///
+		/// \tparam T the type that will be read.
+		template <typename T = std::int32_t>
+		auto readZigZag()
+		{
+			struct Awaiter : AwaiterBase<Awaiter>
+			{
+				VarIntState<std::make_unsigned_t<T>> state;
+
+				bool poll()
+				{
+					return this->state.poll(this->reader);
+				}
+
+				T await_resume()
+				{
+					return encoding::decodeZigZag<T>(this->state.get());
+				}
+			};
+			return Awaiter{{this}, {}};
+		}
+
+		/// \brief Awaitable version of BinaryStream::readString.
+		///
+		/// \tparam T the type that will be used to read the string length.
+		/// \param[in] big_endian Whether to use big endian byte order.
+		template <typename T>
+		auto readString(bool big_endian = true)
+		{
+			struct Awaiter : AwaiterBase<Awaiter>
+			{
+				bool big_endian;
+				std::optional<T> str_size;
+
+				bool poll()
+				{
+					if (!this->str_size) {
+						if (this->reader->getNumOfBytesAvailable() < sizeof(T))
+							return false;
+						this->str_size = this->reader->stream.template read<T>(this->big_endian);
+					}
+					return this->reader->getNumOfBytesAvailable() >= *this->str_size;
+				}
+
+				std::string await_resume()
+				{
+					return this->reader->internalTake(*this->str_size);
+				}
+			};
+			return Awaiter{{this}, big_endian, std::nullopt};
+		}
+
+		/// \brief Awaitable version of BinaryStream::readStringVarInt.
+		///
+		/// \tparam T the type that will be used to read the string length.
+		template <typename T = std::uint32_t>
+		auto readStringVarInt()
+		{
+			struct Awaiter : AwaiterBase<Awaiter>
+			{
+				VarIntState<T> state;
+
+				bool poll()
+				{
+					if (!this->state.poll(this->reader))
+						return false;
+					return this->state.error || this->reader->getNumOfBytesAvailable() >= this->state.value;
+				}
+
+				std::string await_resume()
+				{
+					return this->reader->internalTake(this->state.get());
+				}
+			};
+			return Awaiter{{this}, {}};
+		}
+
+	private:
+		template <typename Derived>
+		struct AwaiterBase
+		{
+			ResumableReader *reader;
+
+			static bool internalPoll(void *awaiter)
+			{
+				return static_cast<Derived *>(awaiter)->poll();
+			}
+
+			bool await_ready()
+			{
+				return static_cast<Derived *>(this)->poll();
+			}
+
+			void await_suspend(std::coroutine_handle<> handle)
+			{
+				this->reader->waiting = handle;
+				this->reader->waiting_poll = &AwaiterBase::internalPoll;
+				this->reader->waiting_awaiter = static_cast<Derived *>(this);
+			}
+		};
+
+		template <typename T>
+		struct VarIntState
+		{
+			T value = 0;
+			std::size_t shift = 0;
+			bool done = false;
+			bool error = false;
+
+			bool poll(ResumableReader *reader)
+			{
+				while (!this->done && reader->getNumOfBytesAvailable() > 0) {
+					std::uint8_t to_read = reader->stream.readSingle();
+					this->value |= static_cast<T>(to_read & 0x7f) << this->shift;
+					this->shift += 7;
+					if ((to_read & 0x80) == 0)
+						this->done = true;
+					else if (this->shift >= (sizeof(T) << 3)) {
+						this->done = true;
+						this->error = true;
+					}
+				}
+				return this->done;
+			}
+
+			T get() const
+			{
+				if (this->error)
+					throw exceptions::VarIntTooBig("Attempted to decode VarInt that is too big to be represented.");
+				return this->value;
+			}
+		};
+
+		BinaryStream stream;
+		std::coroutine_handle<> waiting;
+		bool (*waiting_poll)(void *);
+		void *waiting_awaiter;
+
+		std::string internalTake(std::size_t size);
+		void internalCompact();
+	};
+}
+
+#endif
@@ -0,0 +1,111 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Buffer.hpp"
+#include "BufferView.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace BMLib
+{
+	/// The SharedBuffer class.
+	/// An immutable, reference counted buffer that can be queued to many consumers without copying.
+	/// Copies and slices share the binary data, which is freed when the last of them is destroyed.
+	/// The reference count is atomic, so copies can be passed to and destroyed on other threads.
+	class SharedBuffer
+	{
+	public:
+		/// \brief Initializes an empty SharedBuffer instance.
+		SharedBuffer();
+
+		SharedBuffer(const SharedBuffer &other) noexcept;
+		SharedBuffer &operator=(const SharedBuffer &other) noexcept;
+		SharedBuffer(SharedBuffer &&other) noexcept;
+		SharedBuffer &operator=(SharedBuffer &&other) noexcept;
+
+		/// \brief Releases the reference to the binary data, freeing it if this was the last one.
+		~SharedBuffer();
+
+		/// \brief Freezes the valid bytes of a finished buffer.
+		/// Heap allocated binary data is taken over without copying, inline or non-owned binary data is copied.
+		/// The buffer is left empty.
+		///
+		/// \param[in] buffer The buffer to freeze.
+		///
+		/// \return The resulting shared buffer.
+		static SharedBuffer freeze(Buffer &&buffer);
+
+		/// \brief Copies binary data into a new shared buffer.
+		///
+		/// \param[in] binary The binary data to copy.
+		/// \param[in] size The size of the binary data.
+		///
+		/// \return The resulting shared buffer.
+		static SharedBuffer copy(const std::uint8_t *binary, std::size_t size);
+
+		/// \brief Creates a shared buffer of a part of this one, sharing its binary data.
+		///
+		/// \param[in] offset The offset of the part.
+		/// \param[in] size The size of the part.
+		///
+		/// \return The resulting shared buffer.
+		/// \throws std::out_of_range error
+		SharedBuffer slice(std::size_t offset, std::size_t size) const;
+
+		/// \brief Retrieves the binary data.
+		///
+		/// \return A pointer to the binary data.
+		const std::uint8_t *getBinary() const;
+
+		/// \brief Retrieves the size of the binary data.
+		///
+		/// \return The resulting value.
+		std::size_t getSize() const;
+
+		/// \brief Retrieves the number of shared buffers referencing the binary data.
+		///
+		/// \return The resulting value (0 for an empty shared buffer).
+		std::size_t getUseCount() const;
+
+		/// \brief Checks if the shared buffer is empty.
+		///
+		/// \return Condition of the action.
+		bool empty() const;
+
+		/// \brief Retrieves a view of the binary data, valid while a shared buffer references it.
+		///
+		/// \return The resulting view.
+		BufferView view() const;
+
+	private:
+		struct Control
+		{
+			std::atomic<std::size_t> references;
+			std::uint8_t *binary;
+		};
+
+		Control *control;
+		const std::uint8_t *binary;
+		std::size_t size;
+
+		SharedBuffer(std::uint8_t *owned_binary, std::size_t size);
+
+		void internalRelease();
+	};
+}
@@ -0,0 +1,39 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+// the SSSE3/AVX2 kernels are compiled with per-function target attributes and picked at runtime,
+// so the library does not need to be built with -mavx2 to use them.
+#if !defined(BMLIB_DISABLE_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define BMLIB_SIMD_X86 1
+#define BMLIB_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define BMLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace BMLib::simd
+{
+	/// \brief Checks if the CPU supports SSSE3 and the library was built with the SIMD kernels.
+	///
+	/// \return Condition of the action.
+	bool hasSSSE3();
+
+	/// \brief Checks if the CPU supports AVX2 and the library was built with the SIMD kernels.
+	///
+	/// \return Condition of the action.
+	bool hasAVX2();
+}
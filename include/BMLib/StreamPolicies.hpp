@@ -0,0 +1,73 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+namespace BMLib
+{
+	/// Byte order policy that honours the big_endian argument of every call (the original behaviour).
+	struct RuntimeEndian
+	{
+		static constexpr bool resolve(bool big_endian)
+		{
+			return big_endian;
+		}
+	};
+
+	/// Byte order policy that always uses big endian, the big_endian argument is ignored.
+	struct BigEndian
+	{
+		static constexpr bool resolve(bool)
+		{
+			return true;
+		}
+	};
+
+	/// Byte order policy that always uses little endian, the big_endian argument is ignored.
+	struct LittleEndian
+	{
+		static constexpr bool resolve(bool)
+		{
+			return false;
+		}
+	};
+
+	/// Bounds checking policy that checks every read (the original behaviour).
+	struct Checked
+	{
+		static constexpr bool enabled = true;
+	};
+
+	/// Bounds checking policy that checks reads unless BMLIB_DISABLE_DEBUG_CHECKS is defined.
+	/// The define is set by CMake for release configurations (or as chosen with BINARY_STREAM_DEBUG_CHECKS) and is
+	/// exported with the library, so the library and every translation unit using it agree on the policy
+	/// (NDEBUG is not used for that reason).
+	struct DebugChecked
+	{
+#ifdef BMLIB_DISABLE_DEBUG_CHECKS
+		static constexpr bool enabled = false;
+#else
+		static constexpr bool enabled = true;
+#endif
+	};
+
+	/// Bounds checking policy that never checks reads, the caller must make sure the data is there.
+	struct Unchecked
+	{
+		static constexpr bool enabled = false;
+	};
+}
@@ -0,0 +1,91 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "BinaryStream.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace BMLib
+{
+	/// The StringDictionary class.
+	/// A session-scoped interning table for strings that are written repeatedly.
+	///
+	/// Every string is written as a varint tag: `0` is followed by a varint string that is appended to the table,
+	/// any other value `n` references the entry stored in slot `n - 1`.
+	/// The table is bounded by entry count and by total string bytes, and the oldest entries are evicted first.
+	/// Since only new strings change the table, the writer and the reader evict the same entries in the same order
+	/// as long as both ends are created with the same limits and see the same strings.
+	/// Use one instance per direction of a session.
+	class StringDictionary
+	{
+	public:
+		static constexpr std::size_t DEFAULT_MAX_ENTRIES = 1024;
+		static constexpr std::size_t DEFAULT_MAX_BYTES = 64 * 1024;
+
+		/// \brief Initializes a new StringDictionary instance.
+		///
+		/// \param[in] max_entries The maximum number of interned strings.
+		/// \param[in] max_bytes The maximum number of string bytes kept by the table (strings that are larger are never interned).
+		explicit StringDictionary(std::size_t max_entries = DEFAULT_MAX_ENTRIES, std::size_t max_bytes = DEFAULT_MAX_BYTES);
+
+		/// \brief Writes a string as a reference if it was seen before, otherwise as a literal that gets interned.
+		///
+		/// \param[in] stream The stream to write into.
+		/// \param[in] value The string to write.
+		void writeString(BinaryStream *stream, std::string_view value);
+
+		/// \brief Reads a string written by writeString.
+		///
+		/// \param[in] stream The stream to read from.
+		///
+		/// \return A view of the interned string, which stays valid until the entry is evicted
+		/// (strings too large to be interned stay valid until the next read).
+		/// \throws EndOfStream error
+		/// \throws std::out_of_range if the reference points to an empty slot.
+		std::string_view readString(BinaryStream *stream);
+
+		/// \brief Removes every entry from the table.
+		void clear();
+
+		/// \brief Retrieves the number of interned strings.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfEntries() const;
+
+		/// \brief Retrieves the number of string bytes kept by the table.
+		///
+		/// \return The resulting value.
+		std::size_t getNumOfBytes() const;
+
+	private:
+		std::vector<std::string> slots;
+		std::unordered_map<std::string_view, std::size_t> lookup;
+		std::string oversized;
+		std::size_t max_bytes;
+		std::size_t head;
+		std::size_t count;
+		std::size_t bytes;
+
+		std::size_t internalInsert(std::string_view value);
+		void internalEvictOldest();
+	};
+}
@@ -0,0 +1,32 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BMLib::encoding
+{
+	/// \brief Checks if a range of bytes is well-formed UTF-8 (no overlong forms, surrogates or code points past U+10FFFF).
+	///
+	/// \param[in] binary The bytes to check.
+	/// \param[in] size The number of bytes.
+	///
+	/// \return Condition of the action.
+	bool isValidUtf8(const std::uint8_t *binary, std::size_t size);
+}
@@ -0,0 +1,177 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/AsyncSink.hpp>
+
+#ifndef _WIN32
+
+#include <BMLib/BatchWriter.hpp>
+#include <cerrno>
+#include <exception>
+#include <poll.h>
+#include <system_error>
+
+BMLib::AsyncSink::AsyncSink(int fd, std::size_t buffer_count, std::size_t high_water_mark)
+	: fd(fd), high_water_mark(high_water_mark), in_flight(0), closing(false), closed(false), error(0), bytes_written(0)
+{
+	buffer_count = std::max<std::size_t>(buffer_count, 2);
+	this->streams.reserve(buffer_count);
+	for (std::size_t i = 0; i < buffer_count; ++i) {
+		this->streams.emplace_back(Buffer::create(true, high_water_mark));
+		this->free_streams.push_back(&this->streams.back());
+	}
+	this->active = this->free_streams.front();
+	this->free_streams.pop_front();
+	this->worker = std::thread(&AsyncSink::internalRun, this);
+}
+
+BMLib::AsyncSink::~AsyncSink()
+{
+	try {
+		this->close();
+	} catch (...) {
+	}
+}
+
+BMLib::BinaryStream *BMLib::AsyncSink::getStream()
+{
+	return this->active;
+}
+
+void BMLib::AsyncSink::commit()
+{
+	if (this->active->getBuffer()->position >= this->high_water_mark)
+		this->internalSubmit();
+	this->internalErrorCheck();
+}
+
+void BMLib::AsyncSink::flush()
+{
+	if (this->closed)
+		return;
+	if (this->active->getBuffer()->position > 0)
+		this->internalSubmit();
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->done_cv.wait(lock, [this] { return this->pending_streams.empty() && this->in_flight == 0; });
+	}
+	this->internalErrorCheck();
+}
+
+void BMLib::AsyncSink::close()
+{
+	if (this->closed)
+		return;
+	// the background thread is stopped even if the flush failed, so the error is rethrown after the join.
+	std::exception_ptr flush_error;
+	try {
+		this->flush();
+	} catch (...) {
+		flush_error = std::current_exception();
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->closing = true;
+	}
+	this->work_cv.notify_one();
+	this->worker.join();
+	this->closed = true;
+	if (flush_error)
+		std::rethrow_exception(flush_error);
+}
+
+std::size_t BMLib::AsyncSink::getNumOfBytesWritten() const
+{
+	return this->bytes_written.load(std::memory_order_relaxed);
+}
+
+void BMLib::AsyncSink::internalSubmit()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->pending_streams.push_back(this->active);
+	this->work_cv.notify_one();
+	this->done_cv.wait(lock, [this] { return !this->free_streams.empty(); });
+	this->active = this->free_streams.front();
+	this->free_streams.pop_front();
+}
+
+void BMLib::AsyncSink::internalErrorCheck()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	if (this->error != 0) {
+		int code = this->error;
+		this->error = 0;
+		throw std::system_error(code, std::generic_category(), "Attempted to write buffers to file descriptor " + std::to_string(this->fd));
+	}
+}
+
+void BMLib::AsyncSink::internalRun()
+{
+	std::vector<BinaryStream *> batch;
+	std::unique_lock<std::mutex> lock(this->mutex);
+	while (true) {
+		this->work_cv.wait(lock, [this] { return this->closing || !this->pending_streams.empty(); });
+		if (this->pending_streams.empty())
+			break;
+		batch.assign(this->pending_streams.begin(), this->pending_streams.end());
+		this->pending_streams.clear();
+		this->in_flight = batch.size();
+		lock.unlock();
+
+		int result = this->internalWrite(batch);
+		for (BinaryStream *stream : batch) {
+			stream->getBuffer()->clear();
+			stream->rewind();
+		}
+
+		lock.lock();
+		if (result != 0)
+			this->error = result;
+		this->free_streams.insert(this->free_streams.end(), batch.begin(), batch.end());
+		this->in_flight = 0;
+		this->done_cv.notify_all();
+	}
+}
+
+int BMLib::AsyncSink::internalWrite(const std::vector<BinaryStream *> &batch)
+{
+	BatchWriter writer(this->fd);
+	for (BinaryStream *stream : batch) {
+		Buffer *buffer = stream->getBuffer();
+		writer.add(BufferView(buffer->binary, buffer->position));
+	}
+
+	int result = 0;
+	try {
+		writer.flush();
+		// a non-blocking descriptor that would block keeps the remainder queued until it is writable again.
+		while (!writer.empty()) {
+			pollfd writable = {this->fd, POLLOUT, 0};
+			if (::poll(&writable, 1, -1) < 0 && errno != EINTR) {
+				result = errno;
+				break;
+			}
+			writer.flush();
+		}
+	} catch (const std::system_error &error) {
+		result = error.code().value();
+	}
+	this->bytes_written.fetch_add(writer.getNumOfBytesWritten(), std::memory_order_relaxed);
+	return result;
+}
+
+#endif
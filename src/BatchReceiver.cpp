@@ -0,0 +1,188 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/BatchReceiver.hpp>
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+BMLib::BatchReceiver::BatchReceiver(int fd, std::size_t slot_count, std::size_t slot_size)
+	: fd(fd), slot_count(std::max<std::size_t>(slot_count, 1)), slot_size(slot_size), end_of_stream(false), allocations(0), truncated(0)
+{
+	this->free_buffers.reserve(this->slot_count);
+	this->vectors.resize(this->slot_count);
+#ifdef __linux__
+	this->headers.resize(this->slot_count);
+#endif
+	this->internalRefill();
+}
+
+std::size_t BMLib::BatchReceiver::receiveDatagrams(std::vector<Buffer> &out)
+{
+	std::size_t count = this->internalPrepare();
+	std::size_t received_count = 0;
+#ifdef __linux__
+	for (std::size_t i = 0; i < count; ++i) {
+		this->headers[i] = {};
+		this->headers[i].msg_hdr.msg_iov = &this->vectors[i];
+		this->headers[i].msg_hdr.msg_iovlen = 1;
+	}
+	int received;
+	do {
+		received = ::recvmmsg(this->fd, this->headers.data(), static_cast<unsigned int>(count), MSG_WAITFORONE, nullptr);
+	} while (received < 0 && errno == EINTR);
+	if (received < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return 0;
+		throw std::system_error(errno, std::generic_category(), "Attempted to receive datagrams from file descriptor " + std::to_string(this->fd));
+	}
+	received_count = static_cast<std::size_t>(received);
+#else
+	for (; received_count < count; ++received_count) {
+		msghdr header = {};
+		header.msg_iov = &this->vectors[received_count];
+		header.msg_iovlen = 1;
+		ssize_t received;
+		do {
+			received = ::recvmsg(this->fd, &header, received_count == 0 ? 0 : MSG_DONTWAIT);
+		} while (received < 0 && errno == EINTR);
+		if (received < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+			if (received_count > 0)
+				break;
+			throw std::system_error(errno, std::generic_category(), "Attempted to receive datagrams from file descriptor " + std::to_string(this->fd));
+		}
+		this->vectors[received_count].iov_len = header.msg_flags & MSG_TRUNC ? this->slot_size + 1 : static_cast<std::size_t>(received);
+	}
+#endif
+
+	std::size_t appended = 0;
+	std::size_t first = this->free_buffers.size() - received_count;
+	for (std::size_t i = 0; i < received_count; ++i) {
+		Buffer &buffer = this->free_buffers[this->free_buffers.size() - 1 - i];
+#ifdef __linux__
+		std::size_t size = this->headers[i].msg_len;
+		bool was_truncated = (this->headers[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+#else
+		std::size_t size = this->vectors[i].iov_len;
+		bool was_truncated = size > this->slot_size;
+#endif
+		if (was_truncated) {
+			++this->truncated;
+			continue;
+		}
+		buffer.size = size;
+		buffer.position = 0;
+		out.push_back(std::move(buffer));
+		++appended;
+	}
+	// the truncated datagrams keep their buffers, the others were moved out.
+	std::size_t kept = first;
+	for (std::size_t i = first; i < this->free_buffers.size(); ++i)
+		if (this->free_buffers[i].binary != nullptr)
+			this->free_buffers[kept++] = std::move(this->free_buffers[i]);
+	this->free_buffers.resize(kept);
+	return appended;
+}
+
+std::size_t BMLib::BatchReceiver::receiveStream(std::vector<Buffer> &out)
+{
+	std::size_t count = std::min<std::size_t>(this->internalPrepare(), IOV_MAX);
+	ssize_t received;
+	do {
+		received = ::readv(this->fd, this->vectors.data(), static_cast<int>(count));
+	} while (received < 0 && errno == EINTR);
+	if (received < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return 0;
+		throw std::system_error(errno, std::generic_category(), "Attempted to read from file descriptor " + std::to_string(this->fd));
+	}
+	if (received == 0) {
+		this->end_of_stream = true;
+		return 0;
+	}
+
+	std::size_t remaining = static_cast<std::size_t>(received);
+	std::size_t appended = 0;
+	for (; remaining > 0; ++appended) {
+		Buffer &buffer = this->free_buffers.back();
+		buffer.size = std::min(remaining, this->slot_size);
+		buffer.position = 0;
+		remaining -= buffer.size;
+		out.push_back(std::move(buffer));
+		this->free_buffers.pop_back();
+	}
+	return appended;
+}
+
+void BMLib::BatchReceiver::recycle(Buffer &&buffer)
+{
+	// only buffers that own plain heap binary data can be written into again (not wrapped, adopted or allocator backed ones).
+	if (buffer.binary == nullptr || !buffer.dynamic || buffer.getDeleter() != nullptr || buffer.getAllocator() != nullptr || buffer.capacity < this->slot_size || this->free_buffers.size() >= this->slot_count)
+		return;
+	buffer.clear();
+	this->free_buffers.push_back(std::move(buffer));
+}
+
+void BMLib::BatchReceiver::recycle(std::vector<Buffer> &buffers)
+{
+	for (Buffer &buffer : buffers)
+		this->recycle(std::move(buffer));
+	buffers.clear();
+}
+
+bool BMLib::BatchReceiver::eof() const
+{
+	return this->end_of_stream;
+}
+
+std::size_t BMLib::BatchReceiver::getNumOfAllocations() const
+{
+	return this->allocations;
+}
+
+std::size_t BMLib::BatchReceiver::getNumOfTruncated() const
+{
+	return this->truncated;
+}
+
+void BMLib::BatchReceiver::internalRefill()
+{
+	while (this->free_buffers.size() < this->slot_count) {
+		this->free_buffers.push_back(Buffer::create(false, this->slot_size));
+		++this->allocations;
+	}
+}
+
+std::size_t BMLib::BatchReceiver::internalPrepare()
+{
+	this->internalRefill();
+	// the buffers are taken from the back of the free list.
+	std::size_t count = this->free_buffers.size();
+	for (std::size_t i = 0; i < count; ++i)
+		this->vectors[i] = {this->free_buffers[count - 1 - i].binary, this->slot_size};
+	return count;
+}
+
+#endif
@@ -0,0 +1,103 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/BatchWriter.hpp>
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+BMLib::BatchWriter::BatchWriter(int fd)
+	: fd(fd), index(0), pending_size(0), bytes_written(0), calls(0)
+{
+}
+
+void BMLib::BatchWriter::add(const Buffer &buffer)
+{
+	this->add(BufferView(buffer.binary, buffer.size));
+}
+
+void BMLib::BatchWriter::add(BufferView view)
+{
+	if (view.empty())
+		return;
+	this->vectors.push_back({const_cast<std::uint8_t *>(view.binary), view.size});
+	this->pending_size += view.size;
+}
+
+std::size_t BMLib::BatchWriter::flush()
+{
+	std::size_t flushed = 0;
+	while (this->index < this->vectors.size()) {
+		int count = static_cast<int>(std::min<std::size_t>(this->vectors.size() - this->index, IOV_MAX));
+		ssize_t written = ::writev(this->fd, this->vectors.data() + this->index, count);
+		++this->calls;
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return flushed;
+			throw std::system_error(errno, std::generic_category(), "Attempted to write " + std::to_string(this->pending_size) + " bytes to file descriptor " + std::to_string(this->fd));
+		}
+		std::size_t remaining = static_cast<std::size_t>(written);
+		flushed += remaining;
+		this->bytes_written += remaining;
+		this->pending_size -= remaining;
+		while (this->index < this->vectors.size() && remaining >= this->vectors[this->index].iov_len)
+			remaining -= this->vectors[this->index++].iov_len;
+		if (remaining > 0) {
+			this->vectors[this->index].iov_base = static_cast<std::uint8_t *>(this->vectors[this->index].iov_base) + remaining;
+			this->vectors[this->index].iov_len -= remaining;
+		}
+	}
+	this->clear();
+	return flushed;
+}
+
+void BMLib::BatchWriter::clear()
+{
+	this->vectors.clear();
+	this->index = 0;
+	this->pending_size = 0;
+}
+
+bool BMLib::BatchWriter::empty() const
+{
+	return this->pending_size == 0;
+}
+
+std::size_t BMLib::BatchWriter::getPendingSize() const
+{
+	return this->pending_size;
+}
+
+std::size_t BMLib::BatchWriter::getNumOfBytesWritten() const
+{
+	return this->bytes_written;
+}
+
+std::size_t BMLib::BatchWriter::getNumOfCalls() const
+{
+	return this->calls;
+}
+
+#endif
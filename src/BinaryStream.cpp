@@ -16,112 +16,194 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <BMLib/BinaryStream.hpp>
+#include <BMLib/ByteScan.hpp>
+#include <limits>
 
-BMLib::BinaryStream::BinaryStream(Buffer *buffer, std::size_t position)
-	: buffer(buffer), position(position), curr_read_octet(0), curr_bit_read_pos(0), curr_write_octet(0), curr_bit_write_pos(0)
+template <typename Endian, typename Checking>
+BMLib::BasicBinaryStream<Endian, Checking>::BasicBinaryStream()
+	: buffer(), position(0), curr_write_octet(0), curr_bit_write_pos(0), curr_read_octet(0), curr_bit_read_pos(0)
 {
 }
 
-BMLib::BinaryStream::~BinaryStream()
+template <typename Endian, typename Checking>
+BMLib::BasicBinaryStream<Endian, Checking>::BasicBinaryStream(Buffer &&buffer, std::size_t position)
+	: buffer(std::move(buffer)), position(position), curr_write_octet(0), curr_bit_write_pos(0), curr_read_octet(0), curr_bit_read_pos(0)
 {
-	if (this->buffer) {
-		delete this->buffer;
-		this->buffer = nullptr;
+}
+
+template <typename Endian, typename Checking>
+BMLib::BasicBinaryStream<Endian, Checking>::BasicBinaryStream(std::unique_ptr<Buffer> buffer, std::size_t position)
+	: BasicBinaryStream(std::move(*buffer), position)
+{
+}
+
+template <typename Endian, typename Checking>
+BMLib::BasicBinaryStream<Endian, Checking>::BasicBinaryStream(BasicBinaryStream &&other) noexcept
+	: buffer(std::move(other.buffer)), position(other.position), curr_write_octet(other.curr_write_octet), curr_bit_write_pos(other.curr_bit_write_pos), curr_read_octet(other.curr_read_octet), curr_bit_read_pos(other.curr_bit_read_pos), length_prefixes(std::move(other.length_prefixes))
+{
+	other.rewind();
+	other.resetBitReader();
+	other.resetBitWriter();
+}
+
+template <typename Endian, typename Checking>
+BMLib::BasicBinaryStream<Endian, Checking> &BMLib::BasicBinaryStream<Endian, Checking>::operator=(BasicBinaryStream &&other) noexcept
+{
+	if (this != &other) {
+		this->buffer = std::move(other.buffer);
+		this->position = other.position;
+		this->curr_write_octet = other.curr_write_octet;
+		this->curr_bit_write_pos = other.curr_bit_write_pos;
+		this->curr_read_octet = other.curr_read_octet;
+		this->curr_bit_read_pos = other.curr_bit_read_pos;
+		this->length_prefixes = std::move(other.length_prefixes);
+		other.rewind();
+		other.resetBitReader();
+		other.resetBitWriter();
 	}
+	return *this;
+}
+
+template <typename Endian, typename Checking>
+BMLib::BasicBinaryStream<Endian, Checking>::~BasicBinaryStream() = default;
+
+template <typename Endian, typename Checking>
+BMLib::BasicBinaryStream<Endian, Checking> BMLib::BasicBinaryStream<Endian, Checking>::clone() const
+{
+	BasicBinaryStream result(this->buffer.clone(), this->position);
+	result.curr_write_octet = this->curr_write_octet;
+	result.curr_bit_write_pos = this->curr_bit_write_pos;
+	result.curr_read_octet = this->curr_read_octet;
+	result.curr_bit_read_pos = this->curr_bit_read_pos;
+	result.length_prefixes = this->length_prefixes;
+	return result;
 }
 
-void BMLib::BinaryStream::rewind()
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::rewind()
 {
 	this->position = 0;
 }
 
-void BMLib::BinaryStream::reset(bool auto_realloc, std::size_t alloc_size)
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::reset(bool auto_realloc, std::size_t alloc_size)
 {
+	Buffer::Alignment alignment = this->buffer.getAlignment();
+	BufferAllocator *allocator = this->buffer.getAllocator();
 	this->destroy();
-	this->buffer = Buffer::allocate(auto_realloc, alloc_size);
+	this->buffer = Buffer::create(auto_realloc, alloc_size, alignment, allocator);
 }
 
-void BMLib::BinaryStream::destroy()
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::destroy()
 {
-	if (this->buffer) {
-		delete this->buffer;
-		this->buffer = nullptr;
-	}
+	this->buffer = Buffer(nullptr, 0, 0, false, false);
+	this->length_prefixes.clear();
 	this->rewind();
 	this->resetBitReader();
 	this->resetBitWriter();
 }
 
-void BMLib::BinaryStream::setBuffer(Buffer *buffer)
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::setBuffer(Buffer &&buffer)
 {
-	if (this->buffer)
-		delete this->buffer;
-	this->buffer = buffer;
+	this->buffer = std::move(buffer);
+	this->length_prefixes.clear();
 }
 
-bool BMLib::BinaryStream::eos()
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::setBuffer(std::unique_ptr<Buffer> buffer)
 {
-	return this->position >= this->buffer->size;
+	this->setBuffer(std::move(*buffer));
 }
 
-void BMLib::BinaryStream::ignoreBytes(std::size_t size)
+template <typename Endian, typename Checking>
+bool BMLib::BasicBinaryStream<Endian, Checking>::eos()
+{
+	return this->position >= this->buffer.size;
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::ignoreBytes(std::size_t size)
 {
 	this->position += size;
 }
 
-void BMLib::BinaryStream::resetBitReader()
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::resetBitReader()
 {
 	this->curr_read_octet = this->curr_bit_read_pos = 0;
 }
 
-void BMLib::BinaryStream::resetBitWriter()
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::resetBitWriter()
 {
 	this->curr_write_octet = this->curr_bit_write_pos = 0;
 }
 
-void BMLib::BinaryStream::setPosition(std::size_t value)
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::setPosition(std::size_t value)
 {
 	this->position = value;
 }
 
-BMLib::Buffer *BMLib::BinaryStream::getBuffer()
+template <typename Endian, typename Checking>
+BMLib::Buffer *BMLib::BasicBinaryStream<Endian, Checking>::getBuffer()
 {
-	return this->buffer;
+	return &this->buffer;
 }
 
-std::size_t BMLib::BinaryStream::getNumOfBytesRead() const
+template <typename Endian, typename Checking>
+std::size_t BMLib::BasicBinaryStream<Endian, Checking>::getNumOfBytesRead() const
 {
 	return this->position;
 }
 
-BMLib::Buffer *BMLib::BinaryStream::readAligned(std::size_t size)
+template <typename Endian, typename Checking>
+BMLib::Buffer *BMLib::BasicBinaryStream<Endian, Checking>::readAligned(std::size_t size)
 {
-	this->internalBufferCheck();
-	if (this->eos())
-		throw BMLib::exceptions::EndOfStream("Attempted to read past the end of the stream. No more bytes left to read.");
-	this->position += size;
-	return new Buffer(this->buffer->binary + (this->position - size), size, 0, false, false);
+	BufferView view = this->readView(size);
+	return new Buffer(const_cast<std::uint8_t *>(view.binary), view.size, 0, false, false);
 }
 
-std::uint8_t BMLib::BinaryStream::readSingle()
+template <typename Endian, typename Checking>
+BMLib::BufferView BMLib::BasicBinaryStream<Endian, Checking>::readView(std::size_t size)
 {
-	this->internalBufferCheck();
-	return this->buffer->at(this->position++);
+	return BufferView(this->internalRead(size), size);
+}
+
+template <typename Endian, typename Checking>
+std::uint8_t BMLib::BasicBinaryStream<Endian, Checking>::readSingle()
+{
+	return *this->internalRead(1);
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::writeUInt24Array(const std::uint32_t *values, std::size_t count, bool big_endian)
+{
+	encoding::encodeUInt24Array(values, this->buffer.writeUninitialized(count * 3), count, Endian::resolve(big_endian));
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::writeInt24Array(const std::int32_t *values, std::size_t count, bool big_endian)
+{
+	encoding::encodeInt24Array(values, this->buffer.writeUninitialized(count * 3), count, Endian::resolve(big_endian));
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::writeBoolArray(const bool *values, std::size_t count, bool msb_o)
+{
+	encoding::encodeBoolArray(values, this->buffer.writeUninitialized((count >> 3) + ((count & 7) != 0)), count, msb_o);
 }
 
-void BMLib::BinaryStream::writePadding(std::uint8_t value, std::size_t size)
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::writePadding(std::uint8_t value, std::size_t size)
 {
-	std::uint8_t *tmp;
-	if (value > 0) {
-		tmp = static_cast<std::uint8_t *>(std::malloc(size));
-		std::fill_n(tmp, size, value);
-	} else
-		tmp = static_cast<std::uint8_t *>(std::calloc(size, 1));
-	this->buffer->writeAligned(tmp, size);
-	std::free(tmp);
+	std::memset(this->buffer.writeUninitialized(size), value, size);
 }
 
-void BMLib::BinaryStream::writeBit(bool value, bool skip, bool msb_o)
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::writeBit(bool value, bool skip, bool msb_o)
 {
 	std::uint8_t bit_value = static_cast<std::uint8_t>(value);
 	if (msb_o)
@@ -136,7 +218,16 @@ void BMLib::BinaryStream::writeBit(bool value, bool skip, bool msb_o)
 	}
 }
 
-void BMLib::BinaryStream::writeOptional(std::optional<std::function<void(BinaryStream *)>> value)
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::flushBitWriter()
+{
+	if (this->curr_bit_write_pos > 0)
+		this->write<std::uint8_t>(this->curr_write_octet);
+	this->resetBitWriter();
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::writeOptional(std::optional<std::function<void(BasicBinaryStream *)>> value)
 {
 	bool func_exists = value.has_value();
 	this->write<bool>(func_exists);
@@ -144,26 +235,111 @@ void BMLib::BinaryStream::writeOptional(std::optional<std::function<void(BinaryS
 		(value.value())(this);
 }
 
-BMLib::Buffer *BMLib::BinaryStream::readPadding(std::uint8_t value, std::size_t size)
+template <typename Endian, typename Checking>
+std::size_t BMLib::BasicBinaryStream<Endian, Checking>::endLengthPrefixed()
 {
-	std::uint8_t *tmp;
-	if (value > 0) {
-		tmp = static_cast<std::uint8_t *>(std::malloc(size));
-		std::fill_n(tmp, size, value);
-	} else
-		tmp = static_cast<std::uint8_t *>(std::calloc(size, 1));
-	Buffer *result = this->readAligned(size);
-	if (std::memcmp(result->binary, tmp, size)) {
-		std::free(tmp);
-		throw exceptions::PaddingOutOfRange("Attempted to read padding of a value when there is no padding of that specific value.");
+	if (this->length_prefixes.empty())
+		throw std::runtime_error("Attempted to end a length prefix that was never begun.");
+	LengthPrefix prefix = this->length_prefixes.back();
+	this->length_prefixes.pop_back();
+	// the buffer can be cleared or rewound through getBuffer() while the prefix is open.
+	if (prefix.offset + prefix.width > this->buffer.size || this->buffer.position < prefix.offset + prefix.width)
+		throw std::runtime_error("Attempted to end a length prefix at offset " + std::to_string(prefix.offset) + ", but the buffer no longer holds it.");
+	std::uint8_t *slot = this->buffer.binary + prefix.offset;
+	std::size_t length = this->buffer.position - prefix.offset - prefix.width;
+	if (!prefix.varint) {
+		if (prefix.width < sizeof(std::uint64_t) && length >> (prefix.width << 3) != 0)
+			throw exceptions::FrameTooBig("Attempted to write a length prefixed message of " + std::to_string(length) + " bytes, but its " + std::to_string(prefix.width) + " byte prefix cannot hold it.");
+		switch (prefix.width) {
+		case 1:
+			encoding::encodeFixed<std::uint8_t>(static_cast<std::uint8_t>(length), slot, prefix.big_endian);
+			break;
+		case 2:
+			encoding::encodeFixed<std::uint16_t>(static_cast<std::uint16_t>(length), slot, prefix.big_endian);
+			break;
+		case 4:
+			encoding::encodeFixed<std::uint32_t>(static_cast<std::uint32_t>(length), slot, prefix.big_endian);
+			break;
+		default:
+			encoding::encodeFixed<std::uint64_t>(length, slot, prefix.big_endian);
+			break;
+		}
+		return length;
 	}
-	std::free(tmp);
-	return result;
+
+	if (prefix.width * 7 < 64 && length >> (prefix.width * 7) != 0)
+		throw exceptions::FrameTooBig("Attempted to write a length prefixed message of " + std::to_string(length) + " bytes, but its " + std::to_string(prefix.width) + " byte varint prefix cannot hold it.");
+	if (!prefix.compact) {
+		// a padded varint keeps the continuation bit on every byte but the last.
+		for (std::size_t i = 0; i < prefix.width; ++i)
+			slot[i] = static_cast<std::uint8_t>(((length >> (i * 7)) & 0x7f) | (i + 1 < prefix.width ? 0x80 : 0));
+		return length;
+	}
+	std::uint8_t encoded[10];
+	std::size_t encoded_size = encoding::encodeVarInt<std::uint64_t>(length, encoded);
+	std::size_t shift = prefix.width - encoded_size;
+	if (shift > 0) {
+		// moves everything written after the prefix, which also covers bytes past the position.
+		std::memmove(slot + encoded_size, slot + prefix.width, this->buffer.size - prefix.offset - prefix.width);
+		this->buffer.size -= shift;
+		this->buffer.position -= shift;
+	}
+	std::memcpy(slot, encoded, encoded_size);
+	return length;
 }
 
-bool BMLib::BinaryStream::readBit(bool skip, bool msb_o)
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::readUInt24Array(std::uint32_t *values, std::size_t count, bool big_endian)
 {
-	if (this->curr_read_octet < 1 || this->curr_bit_read_pos == 8 || skip) {
+	encoding::decodeUInt24Array(this->internalRead(this->internalArraySize(count, 3)), values, count, Endian::resolve(big_endian));
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::readInt24Array(std::int32_t *values, std::size_t count, bool big_endian)
+{
+	encoding::decodeInt24Array(this->internalRead(this->internalArraySize(count, 3)), values, count, Endian::resolve(big_endian));
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::readBoolArray(bool *values, std::size_t count, bool msb_o)
+{
+	encoding::decodeBoolArray(this->internalRead((count >> 3) + ((count & 7) != 0)), values, count, msb_o);
+}
+
+template <typename Endian, typename Checking>
+BMLib::Buffer *BMLib::BasicBinaryStream<Endian, Checking>::readPadding(std::uint8_t value, std::size_t size)
+{
+	BufferView view = this->readView(size);
+	if (!simd::isFilledWith(view.binary, view.size, value))
+		throw exceptions::PaddingOutOfRange("Attempted to read padding of a value when there is no padding of that specific value.");
+	return new Buffer(const_cast<std::uint8_t *>(view.binary), view.size, 0, false, false);
+}
+
+template <typename Endian, typename Checking>
+BMLib::BufferView BMLib::BasicBinaryStream<Endian, Checking>::readUntil(std::uint8_t delimiter)
+{
+	this->internalBufferCheck();
+	if (this->position > this->buffer.size)
+		throw exceptions::EndOfStream("Attempted to read past the end of the stream. No more bytes left to read.");
+	const std::uint8_t *begin = this->buffer.binary + this->position;
+	const std::uint8_t *end = simd::findByte(begin, this->buffer.size - this->position, delimiter);
+	if (!end)
+		throw exceptions::EndOfStream("Attempted to read until a delimiter that is not in the rest of the stream.");
+	std::size_t size = static_cast<std::size_t>(end - begin);
+	this->position += size + 1;
+	return BufferView(begin, size);
+}
+
+template <typename Endian, typename Checking>
+BMLib::BufferView BMLib::BasicBinaryStream<Endian, Checking>::readCString()
+{
+	return this->readUntil(0);
+}
+
+template <typename Endian, typename Checking>
+bool BMLib::BasicBinaryStream<Endian, Checking>::readBit(bool skip, bool msb_o)
+{
+	if (this->curr_bit_read_pos == 0 || this->curr_bit_read_pos == 8 || skip) {
 		this->curr_read_octet = this->readSingle();
 		this->curr_bit_read_pos = 0;
 	}
@@ -177,7 +353,8 @@ bool BMLib::BinaryStream::readBit(bool skip, bool msb_o)
 	return (bit_value & 0b1) == 1;
 }
 
-void BMLib::BinaryStream::readOptional(std::optional<std::function<void(BinaryStream *)>> value)
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::readOptional(std::optional<std::function<void(BasicBinaryStream *)>> value)
 {
 	bool func_exists = value.has_value();
 	bool has_structure = this->read<bool>();
@@ -185,14 +362,110 @@ void BMLib::BinaryStream::readOptional(std::optional<std::function<void(BinarySt
 		(value.value())(this);
 }
 
-BMLib::Buffer *BMLib::BinaryStream::readRemaining()
+template <typename Endian, typename Checking>
+BMLib::Buffer *BMLib::BasicBinaryStream<Endian, Checking>::readRemaining()
 {
 	this->internalBufferCheck();
-	return this->readAligned(this->buffer->size - this->position);
+	return this->readAligned(this->buffer.size - this->position);
 }
 
-void BMLib::BinaryStream::internalBufferCheck()
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::skipBits(std::size_t size)
 {
-	if (!this->buffer)
+	if (size == 0)
+		return;
+	if (this->curr_bit_read_pos != 0 && this->curr_bit_read_pos != 8) {
+		std::size_t in_octet = std::min<std::size_t>(size, 8 - this->curr_bit_read_pos);
+		this->curr_bit_read_pos += in_octet;
+		size -= in_octet;
+	}
+	if (size >= 8) {
+		// leaves the bit reader as if the last skipped octet was read bit by bit.
+		this->curr_read_octet = this->internalRead(size >> 3)[(size >> 3) - 1];
+		this->curr_bit_read_pos = 8;
+	}
+	if (size & 7) {
+		this->curr_read_octet = this->readSingle();
+		this->curr_bit_read_pos = size & 7;
+	}
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::internalBeginLengthPrefixed(std::size_t width, bool varint, bool big_endian, bool compact)
+{
+	std::size_t offset = this->buffer.position;
+	this->buffer.writeUninitialized(width);
+	this->length_prefixes.push_back(LengthPrefix{offset, static_cast<std::uint8_t>(width), varint, big_endian, compact});
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::internalBufferCheck()
+{
+	if (!this->buffer.binary)
 		throw std::runtime_error("Attempted to read data from a destroyed buffer.");
 }
+
+template <typename Endian, typename Checking>
+std::size_t BMLib::BasicBinaryStream<Endian, Checking>::internalArraySize(std::size_t count, std::size_t element_size)
+{
+	if constexpr (Checking::enabled) {
+		if (count > std::numeric_limits<std::size_t>::max() / element_size)
+			throw exceptions::EndOfStream("Attempted to read an array that is larger than any stream.");
+	}
+	return count * element_size;
+}
+
+template <typename Endian, typename Checking>
+void BMLib::BasicBinaryStream<Endian, Checking>::internalSkipVarInt(std::size_t max_size)
+{
+	if constexpr (Checking::enabled) {
+		this->internalBufferCheck();
+		if (this->position > this->buffer.size)
+			throw exceptions::EndOfStream("Attempted to read past the end of the stream. No more bytes left to read.");
+	}
+	const std::uint8_t *begin = this->buffer.binary + this->position;
+	std::size_t remaining = this->buffer.size - this->position;
+	std::size_t offset = 0;
+	// looks for the first byte without the continuation bit 8 bytes at a time while the buffer holds them,
+	// the varint size is checked once the terminator was found.
+	for (; offset < max_size && remaining - offset >= 8; offset += 8) {
+		std::uint64_t terminators = ~encoding::decodeFixed<std::uint64_t>(begin + offset, false) & 0x8080808080808080;
+		if (terminators != 0) {
+			std::size_t size = offset + internalLowestByte(terminators) + 1;
+			if (size > max_size)
+				throw exceptions::VarIntTooBig("Attempted to decode VarInt that is too big to be represented.");
+			this->position += size;
+			return;
+		}
+	}
+	std::size_t available = std::min(max_size, remaining);
+	for (; offset < available; ++offset) {
+		if ((begin[offset] & 0x80) == 0) {
+			this->position += offset + 1;
+			return;
+		}
+	}
+	if (available < max_size)
+		throw exceptions::EndOfStream("Attempted to read past the end of the stream. No more bytes left to read.");
+	throw exceptions::VarIntTooBig("Attempted to decode VarInt that is too big to be represented.");
+}
+
+template <typename Endian, typename Checking>
+bool BMLib::BasicBinaryStream<Endian, Checking>::internalReadValidated(std::string &value, std::size_t size)
+{
+	BufferView bytes = this->readView(size);
+	if (!encoding::isValidUtf8(bytes.binary, bytes.size))
+		return false;
+	value.assign((const char *)bytes.binary, bytes.size);
+	return true;
+}
+
+template class BMLib::BasicBinaryStream<BMLib::RuntimeEndian, BMLib::Checked>;
+template class BMLib::BasicBinaryStream<BMLib::RuntimeEndian, BMLib::DebugChecked>;
+template class BMLib::BasicBinaryStream<BMLib::RuntimeEndian, BMLib::Unchecked>;
+template class BMLib::BasicBinaryStream<BMLib::BigEndian, BMLib::Checked>;
+template class BMLib::BasicBinaryStream<BMLib::BigEndian, BMLib::DebugChecked>;
+template class BMLib::BasicBinaryStream<BMLib::BigEndian, BMLib::Unchecked>;
+template class BMLib::BasicBinaryStream<BMLib::LittleEndian, BMLib::Checked>;
+template class BMLib::BasicBinaryStream<BMLib::LittleEndian, BMLib::DebugChecked>;
+template class BMLib::BasicBinaryStream<BMLib::LittleEndian, BMLib::Unchecked>;
@@ -0,0 +1,179 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/BoolArray.hpp>
+#include <BMLib/Simd.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#ifdef BMLIB_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	using ExpandTable = std::array<std::array<bool, 8>, 256>;
+
+	// the 8 flags of every byte value, so a packed byte is unpacked with a single 8 byte copy.
+	constexpr ExpandTable makeExpandTable(bool msb_o)
+	{
+		ExpandTable table{};
+		for (std::size_t value = 0; value < 256; ++value)
+			for (std::size_t bit = 0; bit < 8; ++bit)
+				table[value][bit] = ((value >> (msb_o ? 7 - bit : bit)) & 1) != 0;
+		return table;
+	}
+
+	constexpr ExpandTable MSB_EXPAND_TABLE = makeExpandTable(true);
+	constexpr ExpandTable LSB_EXPAND_TABLE = makeExpandTable(false);
+
+#ifdef BMLIB_SIMD_X86
+	// reverses the flags inside every group of 8 so the movemask of a group lands in MSb order.
+	BMLIB_TARGET_SSSE3 inline __m128i reverseGroupsMask()
+	{
+		return _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+	}
+
+	// the bit every flag of a group is tested against.
+	template <bool MsbOrder>
+	BMLIB_TARGET_SSSE3 inline __m128i groupBitsMask()
+	{
+		if constexpr (MsbOrder)
+			return _mm_setr_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+		else
+			return _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	}
+
+	template <bool MsbOrder>
+	BMLIB_TARGET_SSSE3 std::size_t encodeSSSE3(const bool *in, std::uint8_t *out, std::size_t count)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16) {
+			__m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+			if constexpr (MsbOrder)
+				flags = _mm_shuffle_epi8(flags, reverseGroupsMask());
+			std::uint16_t packed = static_cast<std::uint16_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(flags, zero)));
+			std::memcpy(out + (i >> 3), &packed, sizeof(packed));
+		}
+		return i;
+	}
+
+	template <bool MsbOrder>
+	BMLIB_TARGET_AVX2 std::size_t encodeAVX2(const bool *in, std::uint8_t *out, std::size_t count)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i reverse = _mm256_broadcastsi128_si256(reverseGroupsMask());
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32) {
+			__m256i flags = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+			if constexpr (MsbOrder)
+				flags = _mm256_shuffle_epi8(flags, reverse);
+			std::uint32_t packed = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(flags, zero)));
+			std::memcpy(out + (i >> 3), &packed, sizeof(packed));
+		}
+		return i;
+	}
+
+	template <bool MsbOrder>
+	BMLIB_TARGET_SSSE3 std::size_t decodeSSSE3(const std::uint8_t *in, bool *out, std::size_t count)
+	{
+		// copies the first packed byte into the first 8 lanes and the second one into the last 8 lanes.
+		const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+		const __m128i bits = groupBitsMask<MsbOrder>();
+		const __m128i one = _mm_set1_epi8(1);
+		std::size_t i = 0;
+		for (; i + 16 <= count; i += 16) {
+			std::uint16_t packed;
+			std::memcpy(&packed, in + (i >> 3), sizeof(packed));
+			__m128i flags = _mm_shuffle_epi8(_mm_cvtsi32_si128(packed), spread);
+			flags = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(flags, bits), bits), one);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), flags);
+		}
+		return i;
+	}
+
+	template <bool MsbOrder>
+	BMLIB_TARGET_AVX2 std::size_t decodeAVX2(const std::uint8_t *in, bool *out, std::size_t count)
+	{
+		// every lane holds all 4 packed bytes, the low lane spreads the first 2 and the high lane the last 2.
+		const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+		const __m256i bits = _mm256_broadcastsi128_si256(groupBitsMask<MsbOrder>());
+		const __m256i one = _mm256_set1_epi8(1);
+		std::size_t i = 0;
+		for (; i + 32 <= count; i += 32) {
+			std::int32_t packed;
+			std::memcpy(&packed, in + (i >> 3), sizeof(packed));
+			__m256i flags = _mm256_shuffle_epi8(_mm256_set1_epi32(packed), spread);
+			flags = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(flags, bits), bits), one);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), flags);
+		}
+		return i;
+	}
+#endif
+
+	template <bool MsbOrder>
+	void encodeArray(const bool *in, std::uint8_t *out, std::size_t count)
+	{
+		std::size_t i = 0;
+#ifdef BMLIB_SIMD_X86
+		if (BMLib::simd::hasAVX2())
+			i = encodeAVX2<MsbOrder>(in, out, count);
+		if (BMLib::simd::hasSSSE3())
+			i += encodeSSSE3<MsbOrder>(in + i, out + (i >> 3), count - i);
+#endif
+		for (; i < count; i += 8) {
+			std::uint8_t packed = 0;
+			for (std::size_t bit = 0; bit < 8 && i + bit < count; ++bit)
+				if (in[i + bit])
+					packed |= MsbOrder ? (0x80 >> bit) : (1 << bit);
+			out[i >> 3] = packed;
+		}
+	}
+
+	template <bool MsbOrder>
+	void decodeArray(const std::uint8_t *in, bool *out, std::size_t count)
+	{
+		std::size_t i = 0;
+#ifdef BMLIB_SIMD_X86
+		if (BMLib::simd::hasAVX2())
+			i = decodeAVX2<MsbOrder>(in, out, count);
+		if (BMLib::simd::hasSSSE3())
+			i += decodeSSSE3<MsbOrder>(in + (i >> 3), out + i, count - i);
+#endif
+		const ExpandTable &table = MsbOrder ? MSB_EXPAND_TABLE : LSB_EXPAND_TABLE;
+		for (; i < count; i += 8)
+			std::memcpy(out + i, table[in[i >> 3]].data(), std::min<std::size_t>(8, count - i));
+	}
+}
+
+void BMLib::encoding::encodeBoolArray(const bool *in, std::uint8_t *out, std::size_t count, bool msb_o)
+{
+	if (msb_o)
+		encodeArray<true>(in, out, count);
+	else
+		encodeArray<false>(in, out, count);
+}
+
+void BMLib::encoding::decodeBoolArray(const std::uint8_t *in, bool *out, std::size_t count, bool msb_o)
+{
+	if (msb_o)
+		decodeArray<true>(in, out, count);
+	else
+		decodeArray<false>(in, out, count);
+}
@@ -16,36 +16,201 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <BMLib/Buffer.hpp>
+#include <BMLib/BufferAllocator.hpp>
+#include <BMLib/BufferPool.hpp>
+#include <atomic>
+#include <new>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	constexpr std::size_t CACHE_LINE_SIZE = 64;
+	constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+	std::size_t roundUp(std::size_t value, std::size_t multiple)
+	{
+		return (value + multiple - 1) / multiple * multiple;
+	}
+
+#ifndef _WIN32
+	std::size_t pageSize()
+	{
+		static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+		return size;
+	}
+
+	std::uint8_t *allocateAligned(std::size_t size, std::size_t alignment)
+	{
+		void *result = nullptr;
+		if (posix_memalign(&result, alignment, std::max<std::size_t>(size, 1)) != 0)
+			throw std::bad_alloc();
+		return static_cast<std::uint8_t *>(result);
+	}
+
+	void unmapBinary(std::uint8_t *binary, void *context)
+	{
+		munmap(binary, reinterpret_cast<std::size_t>(context));
+	}
+
+	// explicit huge pages need a reserved pool, the first failure switches to transparent huge pages for good.
+	std::atomic<bool> explicit_huge_pages{true};
+
+	std::uint8_t *mapHugePages(std::size_t size, std::size_t &length)
+	{
+		length = roundUp(size, HUGE_PAGE_SIZE);
+#ifdef MAP_HUGETLB
+		if (explicit_huge_pages.load(std::memory_order_relaxed)) {
+			void *result = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (result != MAP_FAILED)
+				return static_cast<std::uint8_t *>(result);
+			explicit_huge_pages.store(false, std::memory_order_relaxed);
+		}
+#endif
+		// over-maps by one huge page to place the mapping on a huge page boundary, where the kernel can back it with huge pages.
+		void *mapping = mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mapping == MAP_FAILED)
+			throw std::bad_alloc();
+		std::uint8_t *start = static_cast<std::uint8_t *>(mapping);
+		std::uint8_t *aligned = reinterpret_cast<std::uint8_t *>(roundUp(reinterpret_cast<std::uintptr_t>(start), HUGE_PAGE_SIZE));
+		if (aligned != start)
+			munmap(start, aligned - start);
+		if (std::size_t tail = HUGE_PAGE_SIZE - (aligned - start))
+			munmap(aligned + length, tail);
+#ifdef MADV_HUGEPAGE
+		madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+		return aligned;
+	}
+#else
+	std::size_t pageSize()
+	{
+		return 4096;
+	}
+
+	// _aligned_malloc blocks cannot be freed with std::free, so they always carry a deleter.
+	void freeAligned(std::uint8_t *binary, void *)
+	{
+		_aligned_free(binary);
+	}
+#endif
+
+	void deleteVector(std::uint8_t *, void *context)
+	{
+		delete static_cast<std::vector<std::uint8_t> *>(context);
+	}
+
+	void deleteString(std::uint8_t *, void *context)
+	{
+		delete static_cast<std::string *>(context);
+	}
+}
 
 BMLib::Buffer::Buffer(std::uint8_t *binary, std::size_t size, std::size_t position, bool auto_realloc, bool dynamic)
-	: binary(binary), size(size), position(position), auto_realloc(auto_realloc), dynamic(dynamic)
+	: binary(binary), size(size), position(position), auto_realloc(auto_realloc), dynamic(dynamic), capacity(size), spill_size(0), heap_capacity(size), alignment(Alignment::Default), allocator(nullptr), deleter(nullptr), deleter_context(nullptr)
+{
+}
+
+BMLib::Buffer::Buffer()
+	: binary(inline_binary), size(0), position(0), auto_realloc(true), dynamic(true), capacity(INLINE_SIZE), spill_size(DEFAULT_ALLOCATION_SIZE), heap_capacity(0), alignment(Alignment::Default), allocator(nullptr), deleter(nullptr), deleter_context(nullptr)
+{
+}
+
+BMLib::Buffer::Buffer(Buffer &&other) noexcept
 {
+	this->internalTake(other);
+}
+
+BMLib::Buffer &BMLib::Buffer::operator=(Buffer &&other) noexcept
+{
+	if (this != &other) {
+		this->internalRelease();
+		this->internalTake(other);
+	}
+	return *this;
 }
 
 BMLib::Buffer::~Buffer()
 {
-	if (this->dynamic)
-		std::free(this->binary);
+	this->internalRelease();
 	this->binary = nullptr;
 	this->size = this->position = -1;
 }
 
-BMLib::Buffer *BMLib::Buffer::allocate(bool auto_realloc_enabled, std::size_t alloc_size)
+BMLib::Buffer BMLib::Buffer::create(bool auto_realloc_enabled, std::size_t alloc_size, Alignment alignment, BufferAllocator *allocator)
+{
+	Buffer result(nullptr, 0, 0, auto_realloc_enabled);
+	result.alignment = alignment;
+	result.allocator = allocator;
+	result.binary = result.inline_binary;
+	if ((auto_realloc_enabled || alloc_size <= INLINE_SIZE) && (alignment == Alignment::Default || alloc_size == 0)) {
+		result.capacity = auto_realloc_enabled ? INLINE_SIZE : alloc_size;
+		result.spill_size = alloc_size;
+	} else {
+		result.internalReplace(alloc_size);
+		if (!auto_realloc_enabled)
+			result.capacity = alloc_size;
+	}
+	return result;
+}
+
+BMLib::Buffer BMLib::Buffer::adopt(std::uint8_t *binary, std::size_t size, Deleter deleter, void *context)
+{
+	Buffer result(binary, size, size, true);
+	result.deleter = deleter;
+	result.deleter_context = context;
+	return result;
+}
+
+BMLib::Buffer BMLib::Buffer::adopt(std::vector<std::uint8_t> &&storage)
+{
+	// the vector object moves to the heap so its data pointer stays valid while the buffer moves.
+	auto *owner = new std::vector<std::uint8_t>(std::move(storage));
+	return adopt(owner->data(), owner->size(), deleteVector, owner);
+}
+
+BMLib::Buffer BMLib::Buffer::adopt(std::string &&storage)
 {
-	return new Buffer(static_cast<std::uint8_t *>(std::malloc(alloc_size)), alloc_size, 0, auto_realloc_enabled);
+	auto *owner = new std::string(std::move(storage));
+	return adopt(reinterpret_cast<std::uint8_t *>(&(*owner)[0]), owner->size(), deleteString, owner);
 }
 
-void BMLib::Buffer::writeAligned(std::uint8_t *in_binary, std::size_t in_size)
+BMLib::Buffer BMLib::Buffer::wrap(const std::uint8_t *binary, std::size_t size)
+{
+	return Buffer(const_cast<std::uint8_t *>(binary), size, size, false, false);
+}
+
+BMLib::Buffer *BMLib::Buffer::allocate(bool auto_realloc_enabled, std::size_t alloc_size, Alignment alignment, BufferAllocator *allocator)
+{
+	return new Buffer(create(auto_realloc_enabled, alloc_size, alignment, allocator));
+}
+
+BMLib::Buffer BMLib::Buffer::clone() const
+{
+	Buffer result = create(true, this->size, this->alignment, this->allocator);
+	if (this->size > 0)
+		result.writeAligned(this->binary, this->size);
+	result.position = this->position;
+	result.auto_realloc = this->auto_realloc;
+	return result;
+}
+
+void BMLib::Buffer::writeAligned(const std::uint8_t *in_binary, std::size_t in_size)
 {
 	this->internalParamsCheck();
 	this->internalResize(in_size);
 	this->position += in_size;
 	std::memcpy(this->binary + (this->position - in_size), in_binary, in_size);
+	if (this->position > this->size)
+		this->size = this->position;
 }
 
 void BMLib::Buffer::writeAligned(Buffer *in_buffer, bool destroy)
 {
-	this->writeAligned(in_buffer->binary, in_buffer->position);
+	this->writeAligned(in_buffer->binary, in_buffer->size);
 	if (destroy)
 		delete in_buffer;
 }
@@ -55,11 +220,97 @@ void BMLib::Buffer::writeSingle(std::uint8_t value)
 	this->internalParamsCheck();
 	this->internalResize(1);
 	this->binary[this->position++] = value;
+	if (this->position > this->size)
+		this->size = this->position;
+}
+
+std::uint8_t *BMLib::Buffer::writeUninitialized(std::size_t in_size)
+{
+	this->internalParamsCheck();
+	this->internalResize(in_size);
+	this->position += in_size;
+	if (this->position > this->size)
+		this->size = this->position;
+	return this->binary + (this->position - in_size);
+}
+
+void BMLib::Buffer::reserve(std::size_t new_capacity)
+{
+	this->internalParamsCheck();
+	if (new_capacity <= this->capacity)
+		return;
+	if (!this->auto_realloc)
+		throw exceptions::EndOfStream("Attempted to reserve " + std::to_string(new_capacity) + " bytes, but buffer is at maximum size.");
+	this->internalGrow(new_capacity);
+}
+
+std::uint8_t *BMLib::Buffer::releaseBinary()
+{
+	if (!this->dynamic || !this->binary || this->isInline() || this->deleter || this->allocator)
+		return nullptr;
+	std::uint8_t *result = this->binary;
+	this->internalDetach();
+	return result;
+}
+
+std::vector<std::uint8_t> BMLib::Buffer::releaseVector()
+{
+	if (this->deleter == deleteVector) {
+		auto *owner = static_cast<std::vector<std::uint8_t> *>(this->deleter_context);
+		std::vector<std::uint8_t> result = std::move(*owner);
+		result.resize(this->size);
+		delete owner;
+		this->internalDetach();
+		return result;
+	}
+	std::vector<std::uint8_t> result(this->binary, this->binary + this->size);
+	this->clear();
+	return result;
+}
+
+std::string BMLib::Buffer::releaseString()
+{
+	if (this->deleter == deleteString) {
+		auto *owner = static_cast<std::string *>(this->deleter_context);
+		std::string result = std::move(*owner);
+		result.resize(this->size);
+		delete owner;
+		this->internalDetach();
+		return result;
+	}
+	std::string result(reinterpret_cast<const char *>(this->binary), this->size);
+	this->clear();
+	return result;
+}
+
+void BMLib::Buffer::clear()
+{
+	this->size = this->position = 0;
+}
+
+BMLib::Buffer::Alignment BMLib::Buffer::getAlignment() const
+{
+	return this->alignment;
+}
+
+BMLib::BufferAllocator *BMLib::Buffer::getAllocator() const
+{
+	return this->allocator;
+}
+
+BMLib::Buffer::Deleter BMLib::Buffer::getDeleter() const
+{
+	return this->deleter;
+}
+
+bool BMLib::Buffer::isInline() const
+{
+	return this->binary == this->inline_binary;
 }
 
 std::uint8_t BMLib::Buffer::at(std::size_t pos)
 {
-	if (this->size < pos)
+	if (pos >= this->size)
 		throw std::out_of_range("Attempted to access byte at position " + std::to_string(pos) + ", but buffer size is only " + std::to_string(this->size) + " bytes.");
 	return this->binary[pos];
 }
@@ -74,12 +325,142 @@ void BMLib::Buffer::internalParamsCheck()
 
 void BMLib::Buffer::internalResize(std::size_t value)
 {
-	std::size_t new_size = this->size + value;
-	if (new_size > this->size || this->position > this->size) {
-		if (this->auto_realloc) {
-			this->size = new_size;
-			this->binary = static_cast<std::uint8_t *>(std::realloc(this->binary, this->size));
-		} else
+	std::size_t new_size = this->position + value;
+	if (new_size > this->capacity) {
+		if (this->auto_realloc)
+			this->internalGrow(new_size);
+		else
 			throw exceptions::EndOfStream("Attempted to write to buffer at position " + std::to_string(this->position) + ", but buffer is at maximum size.");
 	}
 }
+
+void BMLib::Buffer::internalGrow(std::size_t min_capacity)
+{
+	std::size_t new_capacity = std::max(min_capacity, std::max(this->capacity << 1, this->spill_size));
+	if (this->isInline() || this->deleter || !this->binary)
+		this->internalReplace(new_capacity);
+	else if (this->allocator) {
+		new_capacity = this->allocator->goodSize(new_capacity);
+		this->binary = this->allocator->reallocate(this->binary, this->heap_capacity, new_capacity, this->internalAlignmentSize());
+		this->capacity = this->heap_capacity = new_capacity;
+	} else if (this->alignment != Alignment::Default || BufferPool::isEnabled())
+		this->internalReplace(new_capacity);
+	else {
+		this->binary = static_cast<std::uint8_t *>(std::realloc(this->binary, new_capacity));
+		this->capacity = this->heap_capacity = new_capacity;
+	}
+}
+
+void BMLib::Buffer::internalReplace(std::size_t min_capacity)
+{
+	std::size_t new_capacity = min_capacity;
+	std::uint8_t *heap_binary;
+	Deleter new_deleter = nullptr;
+	void *new_context = nullptr;
+	if (this->allocator) {
+		new_capacity = this->allocator->goodSize(min_capacity);
+		heap_binary = this->allocator->allocate(new_capacity, this->internalAlignmentSize());
+	} else switch (this->alignment) {
+	case Alignment::Default:
+		if (BufferPool::isEnabled())
+			heap_binary = BufferPool::acquire(min_capacity, new_capacity);
+		else
+			heap_binary = static_cast<std::uint8_t *>(std::malloc(min_capacity));
+		break;
+#ifndef _WIN32
+	case Alignment::HugePage:
+		if (min_capacity >= HUGE_PAGE_SIZE) {
+			heap_binary = mapHugePages(min_capacity, new_capacity);
+			new_deleter = unmapBinary;
+			new_context = reinterpret_cast<void *>(new_capacity);
+			break;
+		}
+		// smaller binary data is only page aligned.
+		[[fallthrough]];
+	default:
+		heap_binary = allocateAligned(min_capacity, this->alignment == Alignment::CacheLine ? CACHE_LINE_SIZE : pageSize());
+		break;
+#else
+	default:
+		heap_binary = static_cast<std::uint8_t *>(_aligned_malloc(std::max<std::size_t>(min_capacity, 1), this->alignment == Alignment::CacheLine ? CACHE_LINE_SIZE : pageSize()));
+		if (!heap_binary)
+			throw std::bad_alloc();
+		new_deleter = freeAligned;
+		break;
+#endif
+	}
+	if (std::size_t used = std::max(this->size, this->position))
+		std::memcpy(heap_binary, this->binary, used);
+	if (!this->isInline())
+		this->internalRelease();
+	this->binary = heap_binary;
+	this->capacity = this->heap_capacity = new_capacity;
+	this->deleter = new_deleter;
+	this->deleter_context = new_context;
+}
+
+void BMLib::Buffer::internalRelease()
+{
+	if (this->deleter)
+		this->deleter(this->binary, this->deleter_context);
+	else if (this->dynamic && !this->isInline()) {
+		if (this->allocator)
+			this->allocator->deallocate(this->binary, this->heap_capacity, this->internalAlignmentSize());
+		else
+			internalFree(this->binary, this->heap_capacity);
+	}
+}
+
+void BMLib::Buffer::internalTake(Buffer &other)
+{
+	this->size = other.size;
+	this->position = other.position;
+	this->auto_realloc = other.auto_realloc;
+	this->dynamic = other.dynamic;
+	this->capacity = other.capacity;
+	this->spill_size = other.spill_size;
+	this->heap_capacity = other.heap_capacity;
+	this->alignment = other.alignment;
+	this->allocator = other.allocator;
+	this->deleter = other.deleter;
+	this->deleter_context = other.deleter_context;
+	if (other.isInline()) {
+		std::memcpy(this->inline_binary, other.inline_binary, std::max(other.size, other.position));
+		this->binary = this->inline_binary;
+	} else
+		this->binary = other.binary;
+	other.binary = nullptr;
+	other.size = other.position = other.capacity = other.heap_capacity = 0;
+	other.dynamic = true;
+	other.deleter = nullptr;
+}
+
+void BMLib::Buffer::internalDetach()
+{
+	this->binary = this->inline_binary;
+	this->size = this->position = 0;
+	this->capacity = this->auto_realloc ? INLINE_SIZE : 0;
+	this->heap_capacity = 0;
+	this->deleter = nullptr;
+}
+
+std::size_t BMLib::Buffer::internalAlignmentSize() const
+{
+	switch (this->alignment) {
+	case Alignment::CacheLine:
+		return CACHE_LINE_SIZE;
+	case Alignment::Page:
+	case Alignment::HugePage:
+		return pageSize();
+	default:
+		return alignof(std::max_align_t);
+	}
+}
+
+void BMLib::Buffer::internalFree(std::uint8_t *heap_binary, std::size_t heap_capacity)
+{
+	if (BufferPool::isEnabled())
+		BufferPool::release(heap_binary, heap_capacity);
+	else
+		std::free(heap_binary);
+}
@@ -0,0 +1,178 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/BufferAllocator.hpp>
+#include <BMLib/BufferPool.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace
+{
+	// alignments up to the malloc alignment are served by malloc itself.
+	constexpr std::size_t MALLOC_ALIGNMENT = alignof(std::max_align_t);
+
+	std::uint8_t *allocateSystem(std::size_t size, std::size_t alignment)
+	{
+		void *result;
+		if (alignment <= MALLOC_ALIGNMENT)
+			result = std::malloc(std::max<std::size_t>(size, 1));
+#ifndef _WIN32
+		else if (posix_memalign(&result, alignment, std::max<std::size_t>(size, 1)) != 0)
+			result = nullptr;
+#else
+		else
+			result = _aligned_malloc(std::max<std::size_t>(size, 1), alignment);
+#endif
+		if (!result)
+			throw std::bad_alloc();
+		return static_cast<std::uint8_t *>(result);
+	}
+
+	void deallocateSystem(std::uint8_t *binary, std::size_t alignment)
+	{
+#ifdef _WIN32
+		if (alignment > MALLOC_ALIGNMENT) {
+			_aligned_free(binary);
+			return;
+		}
+#else
+		static_cast<void>(alignment);
+#endif
+		std::free(binary);
+	}
+}
+
+BMLib::BufferAllocator::BufferAllocator()
+	: allocations(0), deallocations(0), reallocations(0), bytes_in_use(0), peak_bytes(0)
+{
+}
+
+std::size_t BMLib::BufferAllocator::goodSize(std::size_t size) const
+{
+	return this->doGoodSize(size);
+}
+
+std::uint8_t *BMLib::BufferAllocator::allocate(std::size_t size, std::size_t alignment)
+{
+	std::uint8_t *result = this->doAllocate(size, alignment);
+	this->allocations.fetch_add(1, std::memory_order_relaxed);
+	this->internalAdd(size);
+	return result;
+}
+
+void BMLib::BufferAllocator::deallocate(std::uint8_t *binary, std::size_t size, std::size_t alignment)
+{
+	if (!binary)
+		return;
+	this->doDeallocate(binary, size, alignment);
+	this->deallocations.fetch_add(1, std::memory_order_relaxed);
+	this->bytes_in_use.fetch_sub(size, std::memory_order_relaxed);
+}
+
+std::uint8_t *BMLib::BufferAllocator::reallocate(std::uint8_t *binary, std::size_t old_size, std::size_t new_size, std::size_t alignment)
+{
+	std::uint8_t *result = this->doReallocate(binary, old_size, new_size, alignment);
+	this->reallocations.fetch_add(1, std::memory_order_relaxed);
+	this->bytes_in_use.fetch_sub(old_size, std::memory_order_relaxed);
+	this->internalAdd(new_size);
+	return result;
+}
+
+BMLib::BufferAllocator::Stats BMLib::BufferAllocator::getStats() const
+{
+	Stats result;
+	result.allocations = this->allocations.load(std::memory_order_relaxed);
+	result.deallocations = this->deallocations.load(std::memory_order_relaxed);
+	result.reallocations = this->reallocations.load(std::memory_order_relaxed);
+	result.bytes_in_use = this->bytes_in_use.load(std::memory_order_relaxed);
+	result.peak_bytes = this->peak_bytes.load(std::memory_order_relaxed);
+	return result;
+}
+
+BMLib::BufferAllocator *BMLib::BufferAllocator::getDefault()
+{
+	static MallocAllocator instance;
+	return &instance;
+}
+
+std::uint8_t *BMLib::BufferAllocator::doReallocate(std::uint8_t *binary, std::size_t old_size, std::size_t new_size, std::size_t alignment)
+{
+	std::uint8_t *result = this->doAllocate(new_size, alignment);
+	std::memcpy(result, binary, std::min(old_size, new_size));
+	this->doDeallocate(binary, old_size, alignment);
+	return result;
+}
+
+std::size_t BMLib::BufferAllocator::doGoodSize(std::size_t size) const
+{
+	return size;
+}
+
+void BMLib::BufferAllocator::internalAdd(std::size_t size)
+{
+	std::size_t in_use = this->bytes_in_use.fetch_add(size, std::memory_order_relaxed) + size;
+	std::size_t peak = this->peak_bytes.load(std::memory_order_relaxed);
+	while (in_use > peak && !this->peak_bytes.compare_exchange_weak(peak, in_use, std::memory_order_relaxed))
+		;
+}
+
+std::uint8_t *BMLib::MallocAllocator::doAllocate(std::size_t size, std::size_t alignment)
+{
+	return allocateSystem(size, alignment);
+}
+
+void BMLib::MallocAllocator::doDeallocate(std::uint8_t *binary, std::size_t, std::size_t alignment)
+{
+	deallocateSystem(binary, alignment);
+}
+
+std::uint8_t *BMLib::MallocAllocator::doReallocate(std::uint8_t *binary, std::size_t old_size, std::size_t new_size, std::size_t alignment)
+{
+	// realloc only keeps the malloc alignment.
+	if (alignment > MALLOC_ALIGNMENT)
+		return BufferAllocator::doReallocate(binary, old_size, new_size, alignment);
+	void *result = std::realloc(binary, std::max<std::size_t>(new_size, 1));
+	if (!result)
+		throw std::bad_alloc();
+	return static_cast<std::uint8_t *>(result);
+}
+
+std::uint8_t *BMLib::PoolAllocator::doAllocate(std::size_t size, std::size_t alignment)
+{
+	if (alignment > MALLOC_ALIGNMENT)
+		return allocateSystem(size, alignment);
+	std::size_t capacity;
+	std::uint8_t *result = BufferPool::acquire(size, capacity);
+	if (!result)
+		throw std::bad_alloc();
+	return result;
+}
+
+void BMLib::PoolAllocator::doDeallocate(std::uint8_t *binary, std::size_t size, std::size_t alignment)
+{
+	if (alignment > MALLOC_ALIGNMENT)
+		deallocateSystem(binary, alignment);
+	else
+		BufferPool::release(binary, size);
+}
+
+std::size_t BMLib::PoolAllocator::doGoodSize(std::size_t size) const
+{
+	return BufferPool::roundSize(size);
+}
@@ -0,0 +1,327 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/BufferPool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+namespace
+{
+	constexpr std::size_t MIN_CLASS_SHIFT = 6;
+	constexpr std::size_t NUM_CLASSES = 15;
+
+	static_assert((std::size_t(1) << MIN_CLASS_SHIFT) == BMLib::BufferPool::MIN_CLASS_SIZE, "MIN_CLASS_SIZE must match MIN_CLASS_SHIFT.");
+	static_assert((BMLib::BufferPool::MIN_CLASS_SIZE << (NUM_CLASSES - 1)) == BMLib::BufferPool::MAX_CLASS_SIZE, "MAX_CLASS_SIZE must match NUM_CLASSES.");
+
+	// free blocks are linked through their own first bytes.
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+
+	struct FreeList
+	{
+		FreeBlock *head = nullptr;
+		std::size_t length = 0;
+
+		void push(std::uint8_t *binary)
+		{
+			FreeBlock *block = reinterpret_cast<FreeBlock *>(binary);
+			block->next = this->head;
+			this->head = block;
+			++this->length;
+		}
+
+		std::uint8_t *pop()
+		{
+			FreeBlock *block = this->head;
+			this->head = block->next;
+			--this->length;
+			return reinterpret_cast<std::uint8_t *>(block);
+		}
+	};
+
+	// the counters are only written by their own thread, so relaxed load/store pairs are enough.
+	inline void bump(std::atomic<std::size_t> &counter, std::size_t amount = 1)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+	inline void drop(std::atomic<std::size_t> &counter, std::size_t amount)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) - amount, std::memory_order_relaxed);
+	}
+
+	struct ThreadCache;
+
+	struct Depot
+	{
+		std::mutex mutex;
+		FreeList lists[NUM_CLASSES];
+		std::size_t bytes = 0;
+		// the statistics of exited threads and of the depot itself.
+		BMLib::BufferPool::Stats retired = {};
+		ThreadCache *caches = nullptr;
+
+		std::atomic<bool> enabled{false};
+		std::atomic<std::size_t> max_list_length{BMLib::BufferPool::Config().max_list_length};
+		std::atomic<std::size_t> max_list_bytes{BMLib::BufferPool::Config().max_list_bytes};
+		std::atomic<std::size_t> max_depot_bytes{BMLib::BufferPool::Config().max_depot_bytes};
+
+		// moves up to count blocks of a size class into the specified list.
+		std::size_t take(std::size_t index, FreeList &list, std::size_t count)
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::size_t taken = 0;
+			for (; taken < count && this->lists[index].head; ++taken)
+				list.push(this->lists[index].pop());
+			this->bytes -= taken * (BMLib::BufferPool::MIN_CLASS_SIZE << index);
+			return taken;
+		}
+
+		// moves count blocks of a size class from the specified list, freeing what exceeds max_depot_bytes.
+		void give(std::size_t index, FreeList &list, std::size_t count)
+		{
+			std::size_t class_size = BMLib::BufferPool::MIN_CLASS_SIZE << index;
+			std::size_t limit = this->max_depot_bytes.load(std::memory_order_relaxed);
+			std::lock_guard<std::mutex> lock(this->mutex);
+			for (std::size_t i = 0; i < count; ++i) {
+				std::uint8_t *binary = list.pop();
+				if (this->bytes + class_size > limit) {
+					std::free(binary);
+					++this->retired.dropped;
+					continue;
+				}
+				this->lists[index].push(binary);
+				this->bytes += class_size;
+			}
+		}
+
+		void clear()
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			for (FreeList &list : this->lists)
+				while (list.head)
+					std::free(list.pop());
+			this->bytes = 0;
+		}
+	};
+
+	// the depot is never destroyed so threads exiting after static destruction can still return their blocks.
+	Depot &depot()
+	{
+		static Depot *instance = new Depot();
+		return *instance;
+	}
+
+	// creates the depot during static initialization instead of inside the first allocation.
+	[[maybe_unused]] Depot &initial_depot = depot();
+
+	thread_local bool cache_destroyed = false;
+
+	struct ThreadCache
+	{
+		FreeList lists[NUM_CLASSES];
+		std::atomic<std::size_t> hits{0};
+		std::atomic<std::size_t> misses{0};
+		std::atomic<std::size_t> recycled{0};
+		std::atomic<std::size_t> dropped{0};
+		std::atomic<std::size_t> retained_bytes{0};
+		ThreadCache *previous = nullptr;
+		ThreadCache *next = nullptr;
+
+		ThreadCache()
+		{
+			Depot &shared = depot();
+			std::lock_guard<std::mutex> lock(shared.mutex);
+			this->next = shared.caches;
+			if (this->next)
+				this->next->previous = this;
+			shared.caches = this;
+		}
+
+		~ThreadCache()
+		{
+			Depot &shared = depot();
+			for (std::size_t i = 0; i < NUM_CLASSES; ++i)
+				shared.give(i, this->lists[i], this->lists[i].length);
+			std::lock_guard<std::mutex> lock(shared.mutex);
+			shared.retired.hits += this->hits.load(std::memory_order_relaxed);
+			shared.retired.misses += this->misses.load(std::memory_order_relaxed);
+			shared.retired.recycled += this->recycled.load(std::memory_order_relaxed);
+			shared.retired.dropped += this->dropped.load(std::memory_order_relaxed);
+			if (this->previous)
+				this->previous->next = this->next;
+			else
+				shared.caches = this->next;
+			if (this->next)
+				this->next->previous = this->previous;
+			cache_destroyed = true;
+		}
+
+		void flush()
+		{
+			for (std::size_t i = 0; i < NUM_CLASSES; ++i)
+				while (this->lists[i].head)
+					std::free(this->lists[i].pop());
+			this->retained_bytes.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	ThreadCache *threadCache()
+	{
+		if (cache_destroyed)
+			return nullptr;
+		thread_local ThreadCache cache;
+		return &cache;
+	}
+
+	std::size_t listCap(const Depot &shared, std::size_t index)
+	{
+		std::size_t by_bytes = shared.max_list_bytes.load(std::memory_order_relaxed) >> (MIN_CLASS_SHIFT + index);
+		return std::max<std::size_t>(1, std::min(shared.max_list_length.load(std::memory_order_relaxed), by_bytes));
+	}
+
+	// the smallest size class that holds size bytes.
+	std::size_t ceilClass(std::size_t size)
+	{
+		std::size_t index = 0;
+		while ((BMLib::BufferPool::MIN_CLASS_SIZE << index) < size)
+			++index;
+		return index;
+	}
+
+	// the largest size class that fits in capacity bytes.
+	std::size_t floorClass(std::size_t capacity)
+	{
+		std::size_t index = 0;
+		while (index + 1 < NUM_CLASSES && (BMLib::BufferPool::MIN_CLASS_SIZE << (index + 1)) <= capacity)
+			++index;
+		return index;
+	}
+}
+
+void BMLib::BufferPool::configure(const Config &config)
+{
+	Depot &shared = depot();
+	shared.max_list_length.store(config.max_list_length, std::memory_order_relaxed);
+	shared.max_list_bytes.store(config.max_list_bytes, std::memory_order_relaxed);
+	shared.max_depot_bytes.store(config.max_depot_bytes, std::memory_order_relaxed);
+	shared.enabled.store(config.enabled, std::memory_order_relaxed);
+}
+
+BMLib::BufferPool::Config BMLib::BufferPool::getConfig()
+{
+	Depot &shared = depot();
+	Config result;
+	result.enabled = shared.enabled.load(std::memory_order_relaxed);
+	result.max_list_length = shared.max_list_length.load(std::memory_order_relaxed);
+	result.max_list_bytes = shared.max_list_bytes.load(std::memory_order_relaxed);
+	result.max_depot_bytes = shared.max_depot_bytes.load(std::memory_order_relaxed);
+	return result;
+}
+
+bool BMLib::BufferPool::isEnabled()
+{
+	return depot().enabled.load(std::memory_order_relaxed);
+}
+
+std::uint8_t *BMLib::BufferPool::acquire(std::size_t size, std::size_t &capacity)
+{
+	ThreadCache *cache = threadCache();
+	if (size > MAX_CLASS_SIZE || !cache) {
+		if (cache)
+			bump(cache->misses);
+		capacity = size;
+		return static_cast<std::uint8_t *>(std::malloc(size));
+	}
+
+	std::size_t index = ceilClass(size);
+	std::size_t class_size = MIN_CLASS_SIZE << index;
+	capacity = class_size;
+	FreeList &list = cache->lists[index];
+	if (!list.head) {
+		Depot &shared = depot();
+		std::size_t taken = shared.take(index, list, std::max<std::size_t>(1, listCap(shared, index) >> 1));
+		bump(cache->retained_bytes, taken * class_size);
+	}
+	if (list.head) {
+		bump(cache->hits);
+		drop(cache->retained_bytes, class_size);
+		return list.pop();
+	}
+	bump(cache->misses);
+	return static_cast<std::uint8_t *>(std::malloc(class_size));
+}
+
+std::size_t BMLib::BufferPool::roundSize(std::size_t size)
+{
+	return size > MAX_CLASS_SIZE ? size : MIN_CLASS_SIZE << ceilClass(size);
+}
+
+void BMLib::BufferPool::release(std::uint8_t *binary, std::size_t capacity)
+{
+	if (!binary)
+		return;
+	ThreadCache *cache = threadCache();
+	if (capacity < MIN_CLASS_SIZE || capacity >= (MAX_CLASS_SIZE << 1) || !cache) {
+		if (cache)
+			bump(cache->dropped);
+		std::free(binary);
+		return;
+	}
+
+	std::size_t index = floorClass(capacity);
+	std::size_t class_size = MIN_CLASS_SIZE << index;
+	FreeList &list = cache->lists[index];
+	list.push(binary);
+	bump(cache->recycled);
+	bump(cache->retained_bytes, class_size);
+
+	Depot &shared = depot();
+	std::size_t cap = listCap(shared, index);
+	if (list.length > cap) {
+		std::size_t count = list.length - (cap >> 1);
+		shared.give(index, list, count);
+		drop(cache->retained_bytes, count * class_size);
+	}
+}
+
+BMLib::BufferPool::Stats BMLib::BufferPool::getStats()
+{
+	Depot &shared = depot();
+	std::lock_guard<std::mutex> lock(shared.mutex);
+	Stats result = shared.retired;
+	result.retained_bytes = shared.bytes;
+	for (ThreadCache *cache = shared.caches; cache; cache = cache->next) {
+		result.hits += cache->hits.load(std::memory_order_relaxed);
+		result.misses += cache->misses.load(std::memory_order_relaxed);
+		result.recycled += cache->recycled.load(std::memory_order_relaxed);
+		result.dropped += cache->dropped.load(std::memory_order_relaxed);
+		result.retained_bytes += cache->retained_bytes.load(std::memory_order_relaxed);
+	}
+	return result;
+}
+
+void BMLib::BufferPool::trim()
+{
+	if (ThreadCache *cache = threadCache())
+		cache->flush();
+	depot().clear();
+}
@@ -0,0 +1,85 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/ByteScan.hpp>
+#include <BMLib/Simd.hpp>
+#include <cstring>
+
+#ifdef BMLIB_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+#ifdef BMLIB_SIMD_X86
+	BMLIB_TARGET_SSSE3 std::size_t isFilledWithSSSE3(const std::uint8_t *binary, std::size_t size, std::uint8_t value, bool &filled)
+	{
+		const __m128i expected = _mm_set1_epi8(static_cast<char>(value));
+		std::size_t i = 0;
+		for (; i + 16 <= size; i += 16) {
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(binary + i));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, expected)) != 0xffff) {
+				filled = false;
+				return i;
+			}
+		}
+		return i;
+	}
+
+	BMLIB_TARGET_AVX2 std::size_t isFilledWithAVX2(const std::uint8_t *binary, std::size_t size, std::uint8_t value, bool &filled)
+	{
+		const __m256i expected = _mm256_set1_epi8(static_cast<char>(value));
+		std::size_t i = 0;
+		// compares 64 bytes per iteration and only checks the combined result, so the loop is bound by the loads.
+		for (; i + 64 <= size; i += 64) {
+			__m256i first = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(binary + i)), expected);
+			__m256i second = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(binary + i + 32)), expected);
+			if (_mm256_movemask_epi8(_mm256_and_si256(first, second)) != -1) {
+				filled = false;
+				return i;
+			}
+		}
+		return i;
+	}
+#endif
+}
+
+bool BMLib::simd::isFilledWith(const std::uint8_t *binary, std::size_t size, std::uint8_t value)
+{
+	std::size_t i = 0;
+	bool filled = true;
+#ifdef BMLIB_SIMD_X86
+	if (hasAVX2())
+		i = isFilledWithAVX2(binary, size, value, filled);
+	if (filled && hasSSSE3())
+		i += isFilledWithSSSE3(binary + i, size - i, value, filled);
+	if (!filled)
+		return false;
+#endif
+	for (; i < size; ++i)
+		if (binary[i] != value)
+			return false;
+	return true;
+}
+
+const std::uint8_t *BMLib::simd::findByte(const std::uint8_t *binary, std::size_t size, std::uint8_t value)
+{
+	// the C library memchr is already vectorized (AVX2/EVEX on glibc), so a custom kernel would not be faster.
+	if (size == 0)
+		return nullptr;
+	return static_cast<const std::uint8_t *>(std::memchr(binary, value, size));
+}
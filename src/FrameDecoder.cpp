@@ -0,0 +1,92 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/FrameDecoder.hpp>
+
+BMLib::FrameDecoder::FrameDecoder(std::size_t max_frame_size)
+	: buffer(), begin(0), max_frame_size(max_frame_size)
+{
+}
+
+void BMLib::FrameDecoder::feed(const std::uint8_t *data, std::size_t size)
+{
+	this->internalCompact();
+	this->buffer.writeAligned(data, size);
+}
+
+std::optional<std::uint32_t> BMLib::FrameDecoder::peekFrameSize() const
+{
+	std::uint32_t frame_size;
+	std::size_t prefix_size;
+	if (!this->internalPeek(frame_size, prefix_size))
+		return std::nullopt;
+	return frame_size;
+}
+
+bool BMLib::FrameDecoder::next(BufferView &frame)
+{
+	std::uint32_t frame_size;
+	std::size_t prefix_size;
+	if (!this->internalPeek(frame_size, prefix_size) || this->getNumOfBytesBuffered() - prefix_size < frame_size)
+		return false;
+	frame = BufferView(this->buffer.binary + this->begin + prefix_size, frame_size);
+	this->begin += prefix_size + frame_size;
+	return true;
+}
+
+std::size_t BMLib::FrameDecoder::getNumOfBytesBuffered() const
+{
+	return this->buffer.position - this->begin;
+}
+
+void BMLib::FrameDecoder::clear()
+{
+	this->buffer.clear();
+	this->begin = 0;
+}
+
+bool BMLib::FrameDecoder::internalPeek(std::uint32_t &frame_size, std::size_t &prefix_size) const
+{
+	const std::uint8_t *prefix = this->buffer.binary + this->begin;
+	std::size_t available = this->getNumOfBytesBuffered();
+	std::uint64_t value = 0;
+	for (std::size_t i = 0; i < 5; ++i) {
+		if (i == available)
+			return false;
+		value |= static_cast<std::uint64_t>(prefix[i] & 0x7f) << (i * 7);
+		if ((prefix[i] & 0x80) == 0) {
+			if (value > UINT32_MAX)
+				break;
+			if (value > this->max_frame_size)
+				throw exceptions::FrameTooBig("Attempted to decode a frame of " + std::to_string(value) + " bytes, but the maximum frame size is " + std::to_string(this->max_frame_size) + " bytes.");
+			frame_size = static_cast<std::uint32_t>(value);
+			prefix_size = i + 1;
+			return true;
+		}
+	}
+	throw exceptions::VarIntTooBig("Attempted to decode VarInt that is too big to be represented.");
+}
+
+void BMLib::FrameDecoder::internalCompact()
+{
+	std::size_t remaining = this->getNumOfBytesBuffered();
+	if (this->begin == 0 || this->begin < remaining)
+		return;
+	std::memmove(this->buffer.binary, this->buffer.binary + this->begin, remaining);
+	this->buffer.size = this->buffer.position = remaining;
+	this->begin = 0;
+}
@@ -0,0 +1,174 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/Int24Array.hpp>
+#include <BMLib/Encoding.hpp>
+#include <BMLib/Integers.hpp>
+#include <BMLib/Simd.hpp>
+#include <cstring>
+
+#ifdef BMLIB_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+#ifdef BMLIB_SIMD_X86
+	// moves the 3 bytes of every packed integer into the top 3 bytes of a 32-bit lane,
+	// so a logical or arithmetic shift by 8 zero or sign extends it.
+	template <bool BigEndian>
+	BMLIB_TARGET_SSSE3 __m128i decodeMask()
+	{
+		if constexpr (BigEndian)
+			return _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+		else
+			return _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+	}
+
+	// moves the low 3 bytes of every 32-bit lane into the first 12 bytes.
+	template <bool BigEndian>
+	BMLIB_TARGET_SSSE3 __m128i encodeMask()
+	{
+		if constexpr (BigEndian)
+			return _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+		else
+			return _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	}
+
+	template <bool Signed, bool BigEndian>
+	BMLIB_TARGET_SSSE3 std::size_t decodeSSSE3(const std::uint8_t *in, std::uint32_t *out, std::size_t count)
+	{
+		const __m128i mask = decodeMask<BigEndian>();
+		std::size_t i = 0;
+		// every load reads 16 bytes for 4 integers, so stop while the last one still fits.
+		for (; i + 6 <= count; i += 4) {
+			__m128i lanes = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 3)), mask);
+			lanes = Signed ? _mm_srai_epi32(lanes, 8) : _mm_srli_epi32(lanes, 8);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), lanes);
+		}
+		return i;
+	}
+
+	template <bool Signed, bool BigEndian>
+	BMLIB_TARGET_AVX2 std::size_t decodeAVX2(const std::uint8_t *in, std::uint32_t *out, std::size_t count)
+	{
+		const __m256i mask = _mm256_broadcastsi128_si256(decodeMask<BigEndian>());
+		std::size_t i = 0;
+		// the upper half is loaded 12 bytes in, so 8 integers read 28 bytes.
+		for (; i + 10 <= count; i += 8) {
+			__m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 3));
+			__m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 3 + 12));
+			__m256i lanes = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), mask);
+			lanes = Signed ? _mm256_srai_epi32(lanes, 8) : _mm256_srli_epi32(lanes, 8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), lanes);
+		}
+		return i;
+	}
+
+	template <bool BigEndian>
+	BMLIB_TARGET_SSSE3 std::size_t encodeSSSE3(const std::uint32_t *in, std::uint8_t *out, std::size_t count)
+	{
+		const __m128i mask = encodeMask<BigEndian>();
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i packed = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), mask);
+			_mm_storel_epi64(reinterpret_cast<__m128i *>(out + i * 3), packed);
+			std::uint32_t last = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+			std::memcpy(out + i * 3 + 8, &last, sizeof(last));
+		}
+		return i;
+	}
+
+	template <bool BigEndian>
+	BMLIB_TARGET_AVX2 std::size_t encodeAVX2(const std::uint32_t *in, std::uint8_t *out, std::size_t count)
+	{
+		const __m256i mask = _mm256_broadcastsi128_si256(encodeMask<BigEndian>());
+		// joins the 12 packed bytes of both halves into the first 24 bytes.
+		const __m256i join = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256i packed = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i)), mask);
+			packed = _mm256_permutevar8x32_epi32(packed, join);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 3), _mm256_castsi256_si128(packed));
+			_mm_storel_epi64(reinterpret_cast<__m128i *>(out + i * 3 + 16), _mm256_extracti128_si256(packed, 1));
+		}
+		return i;
+	}
+#endif
+
+	template <bool Signed, bool BigEndian>
+	void decodeArray(const std::uint8_t *in, std::uint32_t *out, std::size_t count)
+	{
+		std::size_t i = 0;
+#ifdef BMLIB_SIMD_X86
+		if (BMLib::simd::hasAVX2())
+			i = decodeAVX2<Signed, BigEndian>(in, out, count);
+		if (BMLib::simd::hasSSSE3())
+			i += decodeSSSE3<Signed, BigEndian>(in + i * 3, out + i, count - i);
+#endif
+		for (; i < count; ++i) {
+			if constexpr (Signed)
+				out[i] = static_cast<std::uint32_t>(static_cast<std::int32_t>(BMLib::encoding::decodeFixed<BMLib::int24_t>(in + i * 3, BigEndian)));
+			else
+				out[i] = static_cast<std::uint32_t>(BMLib::encoding::decodeFixed<BMLib::uint24_t>(in + i * 3, BigEndian));
+		}
+	}
+
+	template <bool BigEndian>
+	void encodeArray(const std::uint32_t *in, std::uint8_t *out, std::size_t count)
+	{
+		std::size_t i = 0;
+#ifdef BMLIB_SIMD_X86
+		if (BMLib::simd::hasAVX2())
+			i = encodeAVX2<BigEndian>(in, out, count);
+		if (BMLib::simd::hasSSSE3())
+			i += encodeSSSE3<BigEndian>(in + i, out + i * 3, count - i);
+#endif
+		for (; i < count; ++i)
+			BMLib::encoding::encodeFixed<BMLib::uint24_t>(in[i], out + i * 3, BigEndian);
+	}
+}
+
+void BMLib::encoding::decodeUInt24Array(const std::uint8_t *in, std::uint32_t *out, std::size_t count, bool big_endian)
+{
+	if (big_endian)
+		decodeArray<false, true>(in, out, count);
+	else
+		decodeArray<false, false>(in, out, count);
+}
+
+void BMLib::encoding::decodeInt24Array(const std::uint8_t *in, std::int32_t *out, std::size_t count, bool big_endian)
+{
+	std::uint32_t *unsigned_out = reinterpret_cast<std::uint32_t *>(out);
+	if (big_endian)
+		decodeArray<true, true>(in, unsigned_out, count);
+	else
+		decodeArray<true, false>(in, unsigned_out, count);
+}
+
+void BMLib::encoding::encodeUInt24Array(const std::uint32_t *in, std::uint8_t *out, std::size_t count, bool big_endian)
+{
+	if (big_endian)
+		encodeArray<true>(in, out, count);
+	else
+		encodeArray<false>(in, out, count);
+}
+
+void BMLib::encoding::encodeInt24Array(const std::int32_t *in, std::uint8_t *out, std::size_t count, bool big_endian)
+{
+	BMLib::encoding::encodeUInt24Array(reinterpret_cast<const std::uint32_t *>(in), out, count, big_endian);
+}
@@ -0,0 +1,73 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/ResumableDecoder.hpp>
+
+#ifdef __cpp_impl_coroutine
+
+BMLib::ResumableReader::ResumableReader()
+	: stream(), waiting(nullptr), waiting_poll(nullptr), waiting_awaiter(nullptr)
+{
+}
+
+void BMLib::ResumableReader::feed(const std::uint8_t *data, std::size_t size)
+{
+	this->internalCompact();
+	this->stream.getBuffer()->writeAligned(data, size);
+	if (this->waiting && this->waiting_poll(this->waiting_awaiter)) {
+		std::coroutine_handle<> handle = this->waiting;
+		this->cancel();
+		handle.resume();
+	}
+}
+
+void BMLib::ResumableReader::cancel()
+{
+	this->waiting = nullptr;
+	this->waiting_poll = nullptr;
+	this->waiting_awaiter = nullptr;
+}
+
+bool BMLib::ResumableReader::isWaiting() const
+{
+	return static_cast<bool>(this->waiting);
+}
+
+std::size_t BMLib::ResumableReader::getNumOfBytesAvailable()
+{
+	return this->stream.getBuffer()->position - this->stream.getNumOfBytesRead();
+}
+
+std::string BMLib::ResumableReader::internalTake(std::size_t size)
+{
+	std::size_t position = this->stream.getNumOfBytesRead();
+	this->stream.ignoreBytes(size);
+	return std::string(reinterpret_cast<char *>(this->stream.getBuffer()->binary + position), size);
+}
+
+void BMLib::ResumableReader::internalCompact()
+{
+	Buffer *buffer = this->stream.getBuffer();
+	std::size_t consumed = this->stream.getNumOfBytesRead();
+	if (consumed == 0 || consumed < buffer->position - consumed)
+		return;
+	std::memmove(buffer->binary, buffer->binary + consumed, buffer->position - consumed);
+	buffer->size = buffer->position -= consumed;
+	this->stream.rewind();
+}
+
+#endif
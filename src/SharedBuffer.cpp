@@ -0,0 +1,141 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/SharedBuffer.hpp>
+
+BMLib::SharedBuffer::SharedBuffer()
+	: control(nullptr), binary(nullptr), size(0)
+{
+}
+
+BMLib::SharedBuffer::SharedBuffer(std::uint8_t *owned_binary, std::size_t size)
+	: control(new Control{{1}, owned_binary}), binary(owned_binary), size(size)
+{
+}
+
+BMLib::SharedBuffer::SharedBuffer(const SharedBuffer &other) noexcept
+	: control(other.control), binary(other.binary), size(other.size)
+{
+	if (this->control)
+		this->control->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+BMLib::SharedBuffer &BMLib::SharedBuffer::operator=(const SharedBuffer &other) noexcept
+{
+	if (this != &other) {
+		if (other.control)
+			other.control->references.fetch_add(1, std::memory_order_relaxed);
+		this->internalRelease();
+		this->control = other.control;
+		this->binary = other.binary;
+		this->size = other.size;
+	}
+	return *this;
+}
+
+BMLib::SharedBuffer::SharedBuffer(SharedBuffer &&other) noexcept
+	: control(other.control), binary(other.binary), size(other.size)
+{
+	other.control = nullptr;
+	other.binary = nullptr;
+	other.size = 0;
+}
+
+BMLib::SharedBuffer &BMLib::SharedBuffer::operator=(SharedBuffer &&other) noexcept
+{
+	if (this != &other) {
+		this->internalRelease();
+		this->control = other.control;
+		this->binary = other.binary;
+		this->size = other.size;
+		other.control = nullptr;
+		other.binary = nullptr;
+		other.size = 0;
+	}
+	return *this;
+}
+
+BMLib::SharedBuffer::~SharedBuffer()
+{
+	this->internalRelease();
+}
+
+BMLib::SharedBuffer BMLib::SharedBuffer::freeze(Buffer &&buffer)
+{
+	std::size_t size = buffer.size;
+	std::uint8_t *owned_binary = buffer.releaseBinary();
+	if (!owned_binary) {
+		SharedBuffer result = copy(buffer.binary, size);
+		buffer.clear();
+		return result;
+	}
+	return SharedBuffer(owned_binary, size);
+}
+
+BMLib::SharedBuffer BMLib::SharedBuffer::copy(const std::uint8_t *binary, std::size_t size)
+{
+	std::uint8_t *owned_binary = static_cast<std::uint8_t *>(std::malloc(size > 0 ? size : 1));
+	if (size > 0)
+		std::memcpy(owned_binary, binary, size);
+	return SharedBuffer(owned_binary, size);
+}
+
+BMLib::SharedBuffer BMLib::SharedBuffer::slice(std::size_t offset, std::size_t size) const
+{
+	if (offset > this->size || size > this->size - offset)
+		throw std::out_of_range("Attempted to slice " + std::to_string(size) + " bytes at offset " + std::to_string(offset) + ", but shared buffer size is only " + std::to_string(this->size) + " bytes.");
+	SharedBuffer result(*this);
+	result.binary += offset;
+	result.size = size;
+	return result;
+}
+
+const std::uint8_t *BMLib::SharedBuffer::getBinary() const
+{
+	return this->binary;
+}
+
+std::size_t BMLib::SharedBuffer::getSize() const
+{
+	return this->size;
+}
+
+std::size_t BMLib::SharedBuffer::getUseCount() const
+{
+	return this->control ? this->control->references.load(std::memory_order_relaxed) : 0;
+}
+
+bool BMLib::SharedBuffer::empty() const
+{
+	return this->size == 0;
+}
+
+BMLib::BufferView BMLib::SharedBuffer::view() const
+{
+	return BufferView(this->binary, this->size);
+}
+
+void BMLib::SharedBuffer::internalRelease()
+{
+	// the release/acquire pair makes every reader's accesses happen before the binary data is freed.
+	if (this->control && this->control->references.fetch_sub(1, std::memory_order_release) == 1) {
+		std::atomic_thread_fence(std::memory_order_acquire);
+		std::free(this->control->binary);
+		delete this->control;
+	}
+	this->control = nullptr;
+}
@@ -0,0 +1,38 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/Simd.hpp>
+
+bool BMLib::simd::hasSSSE3()
+{
+#ifdef BMLIB_SIMD_X86
+	static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("ssse3"));
+	return supported;
+#else
+	return false;
+#endif
+}
+
+bool BMLib::simd::hasAVX2()
+{
+#ifdef BMLIB_SIMD_X86
+	static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+	return supported;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,98 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <BMLib/StringDictionary.hpp>
+
+BMLib::StringDictionary::StringDictionary(std::size_t max_entries, std::size_t max_bytes)
+	: slots(max_entries > 0 ? max_entries : 1), max_bytes(max_bytes), head(0), count(0), bytes(0)
+{
+	this->lookup.reserve(this->slots.size());
+}
+
+void BMLib::StringDictionary::writeString(BinaryStream *stream, std::string_view value)
+{
+	auto found = this->lookup.find(value);
+	if (found != this->lookup.end()) {
+		stream->writeVarInt<std::uint32_t>(static_cast<std::uint32_t>(found->second + 1));
+		return;
+	}
+	stream->writeVarInt<std::uint32_t>(0);
+	stream->writeVarInt<std::uint32_t>(static_cast<std::uint32_t>(value.size()));
+	stream->getBuffer()->writeAligned((std::uint8_t *)value.data(), value.size());
+	if (value.size() <= this->max_bytes) {
+		std::size_t slot = this->internalInsert(value);
+		this->lookup.emplace(this->slots[slot], slot);
+	}
+}
+
+std::string_view BMLib::StringDictionary::readString(BinaryStream *stream)
+{
+	std::uint32_t tag = stream->readVarInt<std::uint32_t>();
+	if (tag > 0) {
+		std::size_t slot = tag - 1;
+		if (slot >= this->slots.size() || (slot + this->slots.size() - this->head) % this->slots.size() >= this->count)
+			throw std::out_of_range("Attempted to reference string dictionary slot " + std::to_string(slot) + ", but it is empty.");
+		return this->slots[slot];
+	}
+	std::uint32_t str_size = stream->readVarInt<std::uint32_t>();
+	BufferView bytes = stream->readView(str_size);
+	std::string_view value((const char *)bytes.binary, bytes.size);
+	if (value.size() > this->max_bytes) {
+		this->oversized.assign(value);
+		return this->oversized;
+	}
+	return this->slots[this->internalInsert(value)];
+}
+
+void BMLib::StringDictionary::clear()
+{
+	this->lookup.clear();
+	for (std::string &slot : this->slots)
+		slot.clear();
+	this->head = this->count = this->bytes = 0;
+}
+
+std::size_t BMLib::StringDictionary::getNumOfEntries() const
+{
+	return this->count;
+}
+
+std::size_t BMLib::StringDictionary::getNumOfBytes() const
+{
+	return this->bytes;
+}
+
+std::size_t BMLib::StringDictionary::internalInsert(std::string_view value)
+{
+	while (this->count == this->slots.size() || (this->count > 0 && this->bytes + value.size() > this->max_bytes))
+		this->internalEvictOldest();
+	std::size_t slot = (this->head + this->count) % this->slots.size();
+	this->slots[slot].assign(value);
+	this->bytes += value.size();
+	++this->count;
+	return slot;
+}
+
+void BMLib::StringDictionary::internalEvictOldest()
+{
+	std::string &oldest = this->slots[this->head];
+	this->lookup.erase(oldest);
+	this->bytes -= oldest.size();
+	oldest.clear();
+	this->head = (this->head + 1) % this->slots.size();
+	--this->count;
+}
@@ -0,0 +1,269 @@
+// CppBinaryStream
+//
+// Copyright (C) 2025  vp817
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// The vector kernels use the lookup algorithm by John Keiser and Daniel Lemire
+// ("Validating UTF-8 In Less Than One Instruction Per Byte", 2021), as used by simdjson and simdutf:
+// three 16 entry nibble lookups classify every pair of adjacent bytes and the results are AND-ed together,
+// so a byte pair is only an error if every lookup agrees on one of the error bits.
+
+#include <BMLib/Utf8.hpp>
+#include <BMLib/Simd.hpp>
+#include <cstring>
+
+#ifdef BMLIB_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	bool isValidUtf8Scalar(const std::uint8_t *binary, std::size_t size)
+	{
+		std::size_t i = 0;
+		while (i < size) {
+			std::uint8_t lead = binary[i];
+			if (lead < 0x80) {
+				++i;
+				continue;
+			}
+			std::size_t length;
+			// the allowed range of the second byte depends on the lead byte (Unicode table 3-7).
+			std::uint8_t low = 0x80;
+			std::uint8_t high = 0xbf;
+			if (lead >= 0xc2 && lead <= 0xdf)
+				length = 2;
+			else if (lead >= 0xe0 && lead <= 0xef) {
+				length = 3;
+				if (lead == 0xe0)
+					low = 0xa0;
+				else if (lead == 0xed)
+					high = 0x9f;
+			} else if (lead >= 0xf0 && lead <= 0xf4) {
+				length = 4;
+				if (lead == 0xf0)
+					low = 0x90;
+				else if (lead == 0xf4)
+					high = 0x8f;
+			} else
+				return false;
+			if (length > size - i || binary[i + 1] < low || binary[i + 1] > high)
+				return false;
+			for (std::size_t j = 2; j < length; ++j)
+				if ((binary[i + j] & 0xc0) != 0x80)
+					return false;
+			i += length;
+		}
+		return true;
+	}
+
+#ifdef BMLIB_SIMD_X86
+	// the error bits of a byte pair.
+	constexpr std::uint8_t TOO_SHORT = 1 << 0; // a lead byte not followed by a continuation byte.
+	constexpr std::uint8_t TOO_LONG = 1 << 1; // an ASCII byte followed by a continuation byte.
+	constexpr std::uint8_t OVERLONG_3 = 1 << 2;
+	constexpr std::uint8_t TOO_LARGE = 1 << 3;
+	constexpr std::uint8_t SURROGATE = 1 << 4;
+	constexpr std::uint8_t OVERLONG_2 = 1 << 5;
+	constexpr std::uint8_t TOO_LARGE_1000 = 1 << 6;
+	constexpr std::uint8_t OVERLONG_4 = 1 << 6;
+	constexpr std::uint8_t TWO_CONTS = 1 << 7; // two continuation bytes, only valid after a 3 or 4 byte lead.
+	constexpr std::uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+	// looked up by the high nibble of the previous byte.
+	BMLIB_TARGET_SSSE3 inline __m128i byte1HighTable()
+	{
+		return _mm_setr_epi8(
+			TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+			TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+			TOO_SHORT | OVERLONG_2,
+			TOO_SHORT,
+			TOO_SHORT | OVERLONG_3 | SURROGATE,
+			static_cast<char>(TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4));
+	}
+
+	// looked up by the low nibble of the previous byte.
+	BMLIB_TARGET_SSSE3 inline __m128i byte1LowTable()
+	{
+		return _mm_setr_epi8(
+			static_cast<char>(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4),
+			static_cast<char>(CARRY | OVERLONG_2),
+			static_cast<char>(CARRY),
+			static_cast<char>(CARRY),
+			static_cast<char>(CARRY | TOO_LARGE),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000));
+	}
+
+	// looked up by the high nibble of the current byte.
+	BMLIB_TARGET_SSSE3 inline __m128i byte2HighTable()
+	{
+		return _mm_setr_epi8(
+			TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+			static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4),
+			static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE),
+			static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+			static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+			TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+	}
+
+	// the bytes that must not end the input: a 4 byte lead in the last 3 bytes, a 3 byte lead in the last 2 and a 2 byte lead in the last one.
+	BMLIB_TARGET_SSSE3 inline __m128i incompleteTable()
+	{
+		return _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1));
+	}
+
+	struct StateSSSE3
+	{
+		__m128i error;
+		__m128i previous;
+		__m128i incomplete;
+	};
+
+	BMLIB_TARGET_SSSE3 inline void checkBlockSSSE3(StateSSSE3 &state, __m128i input)
+	{
+		const __m128i low_nibble = _mm_set1_epi8(0x0f);
+		__m128i prev1 = _mm_alignr_epi8(input, state.previous, 15);
+		__m128i byte1_high = _mm_shuffle_epi8(byte1HighTable(), _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+		__m128i byte1_low = _mm_shuffle_epi8(byte1LowTable(), _mm_and_si128(prev1, low_nibble));
+		__m128i byte2_high = _mm_shuffle_epi8(byte2HighTable(), _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+		__m128i special = _mm_and_si128(_mm_and_si128(byte1_high, byte1_low), byte2_high);
+
+		// a continuation byte 2 or 3 bytes after a 3 or 4 byte lead is expected, which cancels the TWO_CONTS bit.
+		__m128i prev2 = _mm_alignr_epi8(input, state.previous, 14);
+		__m128i prev3 = _mm_alignr_epi8(input, state.previous, 13);
+		__m128i is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+		__m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+		__m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8(static_cast<char>(0x80)));
+
+		state.error = _mm_or_si128(state.error, _mm_xor_si128(must_be_continuation, special));
+		state.previous = input;
+		state.incomplete = _mm_subs_epu8(input, incompleteTable());
+	}
+
+	BMLIB_TARGET_SSSE3 bool isValidUtf8SSSE3(const std::uint8_t *binary, std::size_t size)
+	{
+		StateSSSE3 state = {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+		std::size_t i = 0;
+		for (; i + 64 <= size; i += 64) {
+			__m128i blocks[4];
+			for (std::size_t j = 0; j < 4; ++j)
+				blocks[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(binary + i + (j << 4)));
+			// ASCII is only checked every 64 bytes, so mixed text does not mispredict on every block.
+			if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(blocks[0], blocks[1]), _mm_or_si128(blocks[2], blocks[3]))) == 0) {
+				// ASCII is only an error if the previous block ended in the middle of a character.
+				state.error = _mm_or_si128(state.error, state.incomplete);
+				state.previous = blocks[3];
+				state.incomplete = _mm_setzero_si128();
+				continue;
+			}
+			for (std::size_t j = 0; j < 4; ++j)
+				checkBlockSSSE3(state, blocks[j]);
+		}
+		for (; i + 16 <= size; i += 16)
+			checkBlockSSSE3(state, _mm_loadu_si128(reinterpret_cast<const __m128i *>(binary + i)));
+		if (i < size) {
+			// the tail is padded with ASCII zeros, which are always valid.
+			std::uint8_t tail[16] = {};
+			std::memcpy(tail, binary + i, size - i);
+			checkBlockSSSE3(state, _mm_loadu_si128(reinterpret_cast<const __m128i *>(tail)));
+		}
+		state.error = _mm_or_si128(state.error, state.incomplete);
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(state.error, _mm_setzero_si128())) == 0xffff;
+	}
+
+	struct StateAVX2
+	{
+		__m256i error;
+		__m256i previous;
+		__m256i incomplete;
+	};
+
+	template <int N>
+	BMLIB_TARGET_AVX2 inline __m256i previousBytesAVX2(__m256i input, __m256i previous)
+	{
+		// the high half of the previous block followed by the low half of the input, so alignr can reach across the lanes.
+		return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+	}
+
+	BMLIB_TARGET_AVX2 inline void checkBlockAVX2(StateAVX2 &state, __m256i input)
+	{
+		const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+		__m256i prev1 = previousBytesAVX2<1>(input, state.previous);
+		__m256i byte1_high = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(byte1HighTable()), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+		__m256i byte1_low = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(byte1LowTable()), _mm256_and_si256(prev1, low_nibble));
+		__m256i byte2_high = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(byte2HighTable()), _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+		__m256i special = _mm256_and_si256(_mm256_and_si256(byte1_high, byte1_low), byte2_high);
+
+		__m256i prev2 = previousBytesAVX2<2>(input, state.previous);
+		__m256i prev3 = previousBytesAVX2<3>(input, state.previous);
+		__m256i is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+		__m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+		__m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+		state.error = _mm256_or_si256(state.error, _mm256_xor_si256(must_be_continuation, special));
+		state.previous = input;
+		// only the high lane holds the last bytes of the block.
+		state.incomplete = _mm256_subs_epu8(input, _mm256_inserti128_si256(_mm256_set1_epi8(-1), incompleteTable(), 1));
+	}
+
+	BMLIB_TARGET_AVX2 bool isValidUtf8AVX2(const std::uint8_t *binary, std::size_t size)
+	{
+		StateAVX2 state = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+		std::size_t i = 0;
+		for (; i + 64 <= size; i += 64) {
+			__m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(binary + i));
+			__m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(binary + i + 32));
+			if (_mm256_movemask_epi8(_mm256_or_si256(first, second)) == 0) {
+				state.error = _mm256_or_si256(state.error, state.incomplete);
+				state.previous = second;
+				state.incomplete = _mm256_setzero_si256();
+				continue;
+			}
+			checkBlockAVX2(state, first);
+			checkBlockAVX2(state, second);
+		}
+		for (; i + 32 <= size; i += 32)
+			checkBlockAVX2(state, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(binary + i)));
+		if (i < size) {
+			std::uint8_t tail[32] = {};
+			std::memcpy(tail, binary + i, size - i);
+			checkBlockAVX2(state, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tail)));
+		}
+		state.error = _mm256_or_si256(state.error, state.incomplete);
+		return _mm256_testz_si256(state.error, state.error) != 0;
+	}
+#endif
+}
+
+bool BMLib::encoding::isValidUtf8(const std::uint8_t *binary, std::size_t size)
+{
+#ifdef BMLIB_SIMD_X86
+	if (simd::hasAVX2())
+		return isValidUtf8AVX2(binary, size);
+	if (simd::hasSSSE3())
+		return isValidUtf8SSSE3(binary, size);
+#endif
+	return isValidUtf8Scalar(binary, size);
+}
@@ -16,12 +16,121 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <BMLib/BinaryStream.hpp>
+#include <BMLib/AsyncSink.hpp>
+#include <BMLib/BatchReceiver.hpp>
+#include <BMLib/BatchWriter.hpp>
+#include <BMLib/BufferAllocator.hpp>
+#include <BMLib/BufferPool.hpp>
+#include <BMLib/FixedWriter.hpp>
+#include <BMLib/FrameDecoder.hpp>
+#include <BMLib/Gorilla.hpp>
+#include <BMLib/LazyRecord.hpp>
+#include <BMLib/ProtoWire.hpp>
+#include <BMLib/ResumableDecoder.hpp>
+#include <BMLib/SharedBuffer.hpp>
+#include <BMLib/StringDictionary.hpp>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <chrono>
+#include <system_error>
+#include <thread>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace BMLib;
 
+// hands out binary data from a fixed arena and never reuses it.
+class ArenaAllocator final : public BufferAllocator
+{
+public:
+	std::size_t used = 0;
+
+protected:
+	std::uint8_t *doAllocate(std::size_t size, std::size_t alignment) override
+	{
+		std::size_t offset = (this->used + alignment - 1) & ~(alignment - 1);
+		if (offset + size > sizeof(this->arena))
+			throw std::bad_alloc();
+		this->used = offset + size;
+		return this->arena + offset;
+	}
+
+	void doDeallocate(std::uint8_t *, std::size_t, std::size_t) override
+	{
+	}
+
+private:
+	alignas(64) std::uint8_t arena[1 << 16];
+};
+
+static constexpr auto fixed_packet = [] {
+	FixedWriter<64> writer;
+	writer.write<std::uint8_t>(0xfe);
+	writer.write<std::uint16_t>(19132);
+	writer.write<std::uint32_t>(0xdeadbeef, false);
+	writer.write<uint24_t>(0xabcdef);
+	writer.write<std::int64_t>(-2, false);
+	writer.writeVarInt<std::uint32_t>(0xffffffff);
+	writer.writeZigZag<std::int32_t>(-100);
+	writer.writeString<std::uint16_t>("handshake");
+	writer.writeStringVarInt("keep-alive");
+	writer.writePadding(0, 4);
+	return writer;
+}();
+static constexpr auto fixed_packet_bytes = fixed_packet.toArray<fixed_packet.getNumOfBytesWritten()>();
+
+static std::size_t allocation_count = 0;
+
+void *operator new(std::size_t size)
+{
+	++allocation_count;
+	if (void *result = std::malloc(size))
+		return result;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+#ifdef __cpp_impl_coroutine
+struct ResumableLogin
+{
+	std::uint32_t id;
+	std::string name;
+	std::uint64_t stamp;
+	std::int64_t delta;
+};
+
+static DecodeTask<std::string> decodeResumableName(ResumableReader &reader)
+{
+	std::string first = co_await reader.readStringVarInt();
+	std::string last = co_await reader.readString<std::uint16_t>();
+	co_return first + " " + last;
+}
+
+static DecodeTask<ResumableLogin> decodeResumableLogin(ResumableReader &reader)
+{
+	ResumableLogin login;
+	login.id = co_await reader.readVarInt<std::uint32_t>();
+	login.name = co_await decodeResumableName(reader);
+	login.stamp = co_await reader.read<std::uint64_t>(false);
+	login.delta = co_await reader.readZigZag<std::int64_t>();
+	co_return login;
+}
+#endif
+
 int main()
 {
-	BinaryStream *stream = new BinaryStream(Buffer::allocate(true,0), 0);
+	BinaryStream *stream = new BinaryStream(std::unique_ptr<Buffer>(Buffer::allocate(true, 0)));
 	printf("Bit Related Stuff:\n");
 	stream->writeBit(true);
 	stream->writeBit(true);
@@ -101,6 +210,9 @@ int main()
 	stream->writeVarInt<std::uint64_t>(1000);
 	stream->writeZigZag(100);
 	stream->writeZigZag<std::int64_t>(1000);
+	stream->writeVarInt<std::uint32_t>(0xffffffff);
+	stream->writeZigZag<std::int32_t>(-100);
+	stream->writeZigZag<std::int64_t>(INT64_MIN);
 	stream->writeString<std::uint32_t>("String Test (Not varint)");
 	stream->writeStringVarInt<std::uint32_t>("String Test (Varint)");
 
@@ -138,6 +250,9 @@ int main()
 	printf("VarInt64: %lu\n", stream->readVarInt<std::uint64_t>());
 	printf("ZigZag32: %u\n", stream->readZigZag());
 	printf("ZigZag64: %li\n", stream->readZigZag<std::int64_t>());
+	printf("VarInt32Max: %u\n", stream->readVarInt<std::uint32_t>());
+	printf("ZigZag32Negative: %d\n", stream->readZigZag<std::int32_t>());
+	printf("ZigZag64Min: %d\n", stream->readZigZag<std::int64_t>() == INT64_MIN ? 1 : 0);
 	printf("String: %s\n", stream->readString<std::uint32_t>().c_str());
 	printf("StringVarInt: %s\n", stream->readStringVarInt().c_str());
 
@@ -204,6 +319,1101 @@ int main()
 
 	printf("OptionalString: %s\n", opt_string.c_str());
 
+	stream->reset(true);
+
+	printf("Gorilla:\n");
+
+	double nan_payload;
+	std::uint64_t nan_bits = 0x7ff8000000001234;
+	std::memcpy(&nan_payload, &nan_bits, sizeof(nan_bits));
+	std::vector<double> samples;
+	for (int i = 0; i < 100; ++i)
+		samples.push_back(20.0 + (i % 10) * 0.25);
+	samples.push_back(nan_payload);
+	samples.push_back(-0.0);
+	samples.push_back(std::numeric_limits<double>::infinity());
+	samples.push_back(1e-300);
+	GorillaEncoder<double>::writeArray(stream, samples.data(), samples.size());
+	std::size_t gorilla_size = stream->getBuffer()->position;
+
+	GorillaEncoder<float> float_encoder(stream);
+	for (int i = 0; i < 16; ++i)
+		float_encoder.write(std::sin(i * 0.1f));
+	float_encoder.finish();
+	stream->write<std::uint8_t>(0xab);
+
+	std::vector<double> decoded_samples = GorillaDecoder<double>::readArray(stream);
+	bool samples_match = decoded_samples.size() == samples.size() && std::memcmp(decoded_samples.data(), samples.data(), samples.size() * sizeof(double)) == 0;
+	printf("GorillaDoubleRoundTrip: %d\n", samples_match ? 1 : 0);
+	printf("GorillaDoubleSize: %zu (raw %zu)\n", gorilla_size, samples.size() * sizeof(double));
+
+	GorillaDecoder<float> float_decoder(stream);
+	bool floats_match = true;
+	for (int i = 0; i < 16; ++i) {
+		float value = float_decoder.read();
+		floats_match = floats_match && value == std::sin(i * 0.1f);
+	}
+	float_decoder.finish();
+	printf("GorillaFloatRoundTrip: %d\n", floats_match ? 1 : 0);
+	printf("GorillaTrailingByte: 0x%x\n", stream->read<std::uint8_t>());
+
+	stream->reset(true);
+
+	printf("StringDictionary:\n");
+
+	StringDictionary write_dictionary(2, 32);
+	StringDictionary read_dictionary(2, 32);
+	const char *names[] = {"Steve", "Alex", "Steve", "Steve", "minecraft:diamond_sword", "Alex", "a string that is too large to be interned", "Steve"};
+	for (const char *name : names)
+		write_dictionary.writeString(stream, name);
+	printf("DictionaryEncodedSize: %zu\n", stream->getBuffer()->position);
+	for (const char *name : names) {
+		std::string_view value = read_dictionary.readString(stream);
+		printf("DictionaryString: %.*s (%d)\n", static_cast<int>(value.size()), value.data(), value == name ? 1 : 0);
+	}
+	printf("DictionaryEntries: %zu/%zu\n", read_dictionary.getNumOfEntries(), write_dictionary.getNumOfEntries());
+	printf("DictionaryBytes: %zu/%zu\n", read_dictionary.getNumOfBytes(), write_dictionary.getNumOfBytes());
+
+	printf("AsyncSink:\n");
+
+	FILE *sink_file = std::tmpfile();
+	{
+		AsyncSink sink(fileno(sink_file), 3, 64);
+		for (std::uint32_t i = 0; i < 1000; ++i) {
+			sink.getStream()->writeVarInt<std::uint32_t>(i);
+			sink.getStream()->writeStringVarInt("sink message");
+			sink.commit();
+		}
+		sink.flush();
+		printf("AsyncSinkFlushedBytes: %zu\n", sink.getNumOfBytesWritten());
+		sink.close();
+	}
+	off_t sink_size = ::lseek(fileno(sink_file), 0, SEEK_END);
+	stream->reset(true, 0);
+	std::vector<std::uint8_t> sink_bytes(static_cast<std::size_t>(sink_size));
+	::pread(fileno(sink_file), sink_bytes.data(), sink_bytes.size(), 0);
+	stream->getBuffer()->writeAligned(sink_bytes.data(), sink_bytes.size());
+	bool sink_matches = true;
+	for (std::uint32_t i = 0; i < 1000; ++i)
+		sink_matches = sink_matches && stream->readVarInt<std::uint32_t>() == i && stream->readStringVarInt() == "sink message";
+	printf("AsyncSinkRoundTrip: %d (%ld bytes)\n", sink_matches && stream->eos() ? 1 : 0, static_cast<long>(sink_size));
+	std::fclose(sink_file);
+
+	bool sink_close_thrown = false;
+	{
+		AsyncSink failing_sink(-1, 2, 16);
+		failing_sink.getStream()->writeStringVarInt("never written");
+		failing_sink.commit();
+		try {
+			failing_sink.close();
+		} catch (const std::system_error &) {
+			sink_close_thrown = true;
+		}
+	}
+	{
+		AsyncSink failing_sink(-1, 2, 16);
+		failing_sink.getStream()->writeStringVarInt("never written");
+	}
+	int sink_sockets[2];
+	::socketpair(AF_UNIX, SOCK_STREAM, 0, sink_sockets);
+	::fcntl(sink_sockets[0], F_SETFL, ::fcntl(sink_sockets[0], F_GETFL) | O_NONBLOCK);
+	int sink_send_size = 4096;
+	::setsockopt(sink_sockets[0], SOL_SOCKET, SO_SNDBUF, &sink_send_size, sizeof(sink_send_size));
+	std::vector<std::uint8_t> sink_received;
+	std::thread sink_reader([&sink_received, &sink_sockets] {
+		std::uint8_t chunk[1024];
+		ssize_t received;
+		while ((received = ::recv(sink_sockets[1], chunk, sizeof(chunk), 0)) > 0) {
+			sink_received.insert(sink_received.end(), chunk, chunk + received);
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	});
+	{
+		AsyncSink nonblocking_sink(sink_sockets[0], 2, 4096);
+		for (std::uint32_t i = 0; i < 25000; ++i) {
+			nonblocking_sink.getStream()->write<std::uint32_t>(i);
+			nonblocking_sink.commit();
+		}
+	}
+	::close(sink_sockets[0]);
+	sink_reader.join();
+	::close(sink_sockets[1]);
+	bool nonblocking_matches = sink_received.size() == 100000;
+	for (std::uint32_t i = 0; nonblocking_matches && i < 25000; ++i)
+		nonblocking_matches = encoding::decodeFixed<std::uint32_t>(sink_received.data() + i * 4, true) == i;
+	printf("AsyncSinkNonBlocking: %zu bytes, matches %d\n", sink_received.size(), nonblocking_matches ? 1 : 0);
+	printf("AsyncSinkFailedClose: thrown %d, destroyed 1\n", sink_close_thrown ? 1 : 0);
+
+	printf("InlineBuffer:\n");
+
+	stream->reset(true);
+	stream->write<std::uint32_t>(0xdeadbeef);
+	stream->writeStringVarInt("ack");
+	printf("InlineSmallMessage: %d (%zu bytes)\n", stream->getBuffer()->isInline() ? 1 : 0, stream->getBuffer()->size);
+	stream->writePadding(0x7f, Buffer::INLINE_SIZE);
+	printf("InlineSpilled: %d (capacity %zu)\n", stream->getBuffer()->isInline() ? 0 : 1, stream->getBuffer()->capacity);
+	printf("InlineAt: 0x%x 0x%x\n", stream->getBuffer()->at(0), stream->getBuffer()->at(stream->getBuffer()->size - 1));
+	printf("InlineRead: 0x%x\n", stream->read<std::uint32_t>());
+	printf("InlineReadString: %s\n", stream->readStringVarInt().c_str());
+	Buffer *fixed_buffer = Buffer::allocate(false, 8);
+	fixed_buffer->writeAligned((std::uint8_t *)"12345678", 8);
+	try {
+		fixed_buffer->writeSingle('9');
+	} catch (exceptions::EndOfStream &error) {
+		printf("%s\n", error.what());
+	}
+	delete fixed_buffer;
+
+	printf("ValueStream:\n");
+
+	std::size_t allocations_before = allocation_count;
+	BinaryStream value_stream;
+	for (std::uint32_t i = 0; i < 1000; ++i) {
+		value_stream.getBuffer()->clear();
+		value_stream.rewind();
+		value_stream.write<std::uint16_t>(static_cast<std::uint16_t>(i));
+		value_stream.writeVarInt<std::uint32_t>(i * 1000);
+		value_stream.writeFloat<double>(i * 0.5);
+		value_stream.read<std::uint16_t>();
+		value_stream.readVarInt<std::uint32_t>();
+		value_stream.readFloat<double>();
+	}
+	printf("ValueStreamAllocations: %zu\n", allocation_count - allocations_before);
+	BinaryStream moved_stream(std::move(value_stream));
+	BinaryStream cloned_stream = moved_stream.clone();
+	cloned_stream.rewind();
+	printf("ValueStreamMoved: %u %d\n", cloned_stream.read<std::uint16_t>(), value_stream.getBuffer()->size == 0 ? 1 : 0);
+
+	printf("FixedWriter:\n");
+
+	stream->reset(true);
+	stream->write<std::uint8_t>(0xfe);
+	stream->write<std::uint16_t>(19132);
+	stream->write<std::uint32_t>(0xdeadbeef, false);
+	stream->write<uint24_t>(0xabcdef);
+	stream->write<std::int64_t>(-2, false);
+	stream->writeVarInt<std::uint32_t>(0xffffffff);
+	stream->writeZigZag<std::int32_t>(-100);
+	stream->writeString<std::uint16_t>("handshake");
+	stream->writeStringVarInt("keep-alive");
+	stream->writePadding(0, 4);
+	printf("FixedWriterSize: %zu\n", fixed_packet_bytes.size());
+	printf("FixedWriterMatches: %d\n", stream->getBuffer()->size == fixed_packet_bytes.size() && std::memcmp(stream->getBuffer()->binary, fixed_packet_bytes.data(), fixed_packet_bytes.size()) == 0 ? 1 : 0);
+
+	printf("StreamPolicies:\n");
+
+	BasicBinaryStream<LittleEndian> little_stream;
+	little_stream.write<std::uint32_t>(0xdeadbeef);
+	little_stream.write<uint24_t>(0xabcdef);
+	little_stream.writeFloat<double>(-1.25);
+	little_stream.writeString<std::uint16_t>("policy");
+	stream->reset(true);
+	stream->write<std::uint32_t>(0xdeadbeef, false);
+	stream->write<uint24_t>(0xabcdef, false);
+	stream->writeFloat<double>(-1.25, false);
+	stream->writeString<std::uint16_t>("policy", false);
+	printf("PolicyLittleMatches: %d\n", little_stream.getBuffer()->size == stream->getBuffer()->size && std::memcmp(little_stream.getBuffer()->binary, stream->getBuffer()->binary, stream->getBuffer()->size) == 0 ? 1 : 0);
+	BasicBinaryStream<LittleEndian, Unchecked> unchecked_stream(std::move(*little_stream.getBuffer()));
+	printf("PolicyUncheckedRead: 0x%x\n", unchecked_stream.read<std::uint32_t>());
+	printf("PolicyUncheckedRead: 0x%x\n", static_cast<std::uint32_t>(unchecked_stream.read<uint24_t>()));
+	printf("PolicyUncheckedRead: %f\n", unchecked_stream.readFloat<double>());
+	printf("PolicyUncheckedRead: %s\n", unchecked_stream.readString<std::uint16_t>().c_str());
+	BasicBinaryStream<BigEndian> big_stream;
+	big_stream.write<std::uint16_t>(0x1234, false);
+	printf("PolicyBigIgnoresArgument: 0x%x 0x%x\n", big_stream.getBuffer()->at(0), big_stream.getBuffer()->at(1));
+	try {
+		big_stream.read<std::uint32_t>();
+	} catch (exceptions::EndOfStream &error) {
+		printf("%s\n", error.what());
+	}
+
+	printf("Int24Array:\n");
+
+	printf("Int24SignExtend: %d %d %d\n", static_cast<std::int32_t>(int24_t(-1)), static_cast<std::int32_t>(int24_t(-8388608)), static_cast<std::int32_t>(int24_t(8388607)));
+	bool int24_matches = true;
+	for (std::size_t count : {0, 1, 3, 4, 5, 7, 8, 9, 10, 11, 17, 33, 1000}) {
+		for (bool big_endian : {true, false}) {
+			std::vector<std::int32_t> samples(count);
+			std::vector<std::uint32_t> sequences(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				samples[i] = static_cast<std::int32_t>(i * 40503 % 16777216) - 8388608;
+				sequences[i] = static_cast<std::uint32_t>(i * 2654435761u) & 0xffffff;
+			}
+			stream->reset(true);
+			stream->writeInt24Array(samples.data(), count, big_endian);
+			stream->writeUInt24Array(sequences.data(), count, big_endian);
+			for (std::size_t i = 0; i < count; ++i)
+				int24_matches = int24_matches && static_cast<std::int32_t>(stream->read<int24_t>(big_endian)) == samples[i];
+			for (std::size_t i = 0; i < count; ++i)
+				int24_matches = int24_matches && static_cast<std::uint32_t>(stream->read<uint24_t>(big_endian)) == sequences[i];
+			std::vector<std::int32_t> read_samples(count);
+			std::vector<std::uint32_t> read_sequences(count);
+			stream->rewind();
+			stream->readInt24Array(read_samples.data(), count, big_endian);
+			stream->readUInt24Array(read_sequences.data(), count, big_endian);
+			int24_matches = int24_matches && read_samples == samples && read_sequences == sequences && stream->eos();
+		}
+	}
+	printf("Int24ArrayRoundTrip: %d\n", int24_matches ? 1 : 0);
+
+	printf("BoolArray:\n");
+
+	bool bool_matches = true;
+	for (std::size_t count : {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000}) {
+		for (bool msb_o : {true, false}) {
+			std::vector<bool> flags(count);
+			std::unique_ptr<bool[]> raw_flags(new bool[count + 1]);
+			for (std::size_t i = 0; i < count; ++i)
+				raw_flags[i] = flags[i] = (i * 2654435761u >> 7) % 3 == 0;
+			stream->reset(true);
+			for (std::size_t i = 0; i < count; ++i)
+				stream->writeBit(flags[i], false, msb_o);
+			stream->flushBitWriter();
+			std::size_t bit_size = stream->getBuffer()->size;
+			stream->writeBoolArray(raw_flags.get(), count, msb_o);
+			stream->writeBoolArray(flags, msb_o);
+			bool_matches = bool_matches && stream->getBuffer()->size == bit_size * 3 && std::memcmp(stream->getBuffer()->binary, stream->getBuffer()->binary + bit_size, bit_size) == 0 && std::memcmp(stream->getBuffer()->binary, stream->getBuffer()->binary + bit_size * 2, bit_size) == 0;
+			stream->setPosition(bit_size);
+			std::unique_ptr<bool[]> read_raw_flags(new bool[count + 1]);
+			std::vector<bool> read_flags(count);
+			stream->readBoolArray(read_raw_flags.get(), count, msb_o);
+			stream->readBoolArray(read_flags, msb_o);
+			bool_matches = bool_matches && read_flags == flags && std::equal(raw_flags.get(), raw_flags.get() + count, read_raw_flags.get()) && stream->eos();
+		}
+	}
+	printf("BoolArrayRoundTrip: %d\n", bool_matches ? 1 : 0);
+	std::bitset<12> visibility("101100000011");
+	stream->reset(true);
+	stream->writeBoolArray(visibility);
+	stream->writeBoolArray(visibility, false);
+	printf("BoolArrayBitset: 0x%x 0x%x 0x%x 0x%x\n", stream->getBuffer()->at(0), stream->getBuffer()->at(1), stream->getBuffer()->at(2), stream->getBuffer()->at(3));
+	std::bitset<12> read_visibility;
+	stream->readBoolArray(read_visibility);
+	printf("BoolArrayBitsetRead: %s\n", read_visibility.to_string().c_str());
+
+	printf("PaddingScan:\n");
+
+	stream->reset(true, 2048);
+	stream->getBuffer()->reserve(2048);
+	allocations_before = allocation_count;
+	stream->writePadding(0x5a, 1500);
+	printf("PaddingWriteAllocations: %zu\n", allocation_count - allocations_before);
+	Buffer *padding = stream->readPadding(0x5a, 1500);
+	printf("PaddingRead: %zu\n", padding->size);
+	delete padding;
+	stream->getBuffer()->binary[1400] = 0x5b;
+	stream->rewind();
+	try {
+		delete stream->readPadding(0x5a, 1500);
+	} catch (exceptions::PaddingOutOfRange &error) {
+		printf("%s\n", error.what());
+	}
+	stream->reset(true);
+	stream->getBuffer()->writeAligned((std::uint8_t *)"MTU probe\0", 10);
+	stream->getBuffer()->writeAligned((std::uint8_t *)"key=value;rest", 14);
+	BufferView c_string = stream->readCString();
+	printf("CString: %.*s (%zu)\n", static_cast<int>(c_string.size), (const char *)c_string.binary, c_string.size);
+	BufferView until = stream->readUntil(';');
+	printf("Until: %.*s %zu\n", static_cast<int>(until.size), (const char *)until.binary, stream->getNumOfBytesRead());
+	try {
+		stream->readUntil(';');
+	} catch (exceptions::EndOfStream &error) {
+		printf("%s\n", error.what());
+	}
+
+	printf("Utf8:\n");
+
+	const std::string utf8_valid[] = {"", "plain ascii", "h\xc3\xa9llo", "\xe2\x82\xac 20", "\xf0\x9f\x98\x80", "\xf4\x8f\xbf\xbf", "\xed\x9f\xbf\xee\x80\x80"};
+	const std::string utf8_invalid[] = {"\xc0\x80", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\x80", "\xe2\x82", "\xff", "a\xc3"};
+	std::size_t utf8_passed = 0;
+	std::size_t utf8_checks = 0;
+	// every case is moved across the vector block boundaries by prefixing it with ASCII.
+	for (std::size_t prefix = 0; prefix < 70; ++prefix) {
+		for (const std::string &text : utf8_valid) {
+			std::string value;
+			stream->reset(true);
+			stream->writeStringVarInt(std::string(prefix, 'a') + text);
+			stream->write<std::uint8_t>(0x42);
+			utf8_passed += stream->readValidatedStringVarInt(value) && value == std::string(prefix, 'a') + text && stream->read<std::uint8_t>() == 0x42;
+			++utf8_checks;
+		}
+		for (const std::string &text : utf8_invalid) {
+			std::string value = "unchanged";
+			stream->reset(true);
+			stream->writeString<std::uint16_t>(std::string(prefix, 'a') + text + std::string(prefix, 'b'));
+			stream->write<std::uint8_t>(0x42);
+			utf8_passed += !stream->readValidatedString<std::uint16_t>(value) && value == "unchanged" && stream->read<std::uint8_t>() == 0x42;
+			++utf8_checks;
+		}
+	}
+	printf("Utf8Validation: %zu/%zu\n", utf8_passed, utf8_checks);
+
+	printf("SharedBuffer:\n");
+
+	stream->reset(true);
+	for (std::uint32_t i = 0; i < 250; ++i)
+		stream->write<std::uint32_t>(i);
+	const std::uint8_t *payload_binary = stream->getBuffer()->binary;
+	SharedBuffer payload = SharedBuffer::freeze(std::move(*stream->getBuffer()));
+	printf("SharedFreezeZeroCopy: %d (%zu bytes, stream left with %zu)\n", payload.getBinary() == payload_binary ? 1 : 0, payload.getSize(), stream->getBuffer()->size);
+	{
+		std::vector<SharedBuffer> queues;
+		queues.reserve(2000);
+		allocations_before = allocation_count;
+		queues.assign(2000, payload);
+		printf("SharedFanOut: %zu references, %zu allocations\n", payload.getUseCount(), allocation_count - allocations_before);
+		std::vector<std::thread> consumers;
+		for (std::size_t t = 0; t < 4; ++t)
+			consumers.emplace_back([&queues, t] {
+				for (std::size_t i = t; i < queues.size(); i += 4)
+					queues[i] = SharedBuffer();
+			});
+		for (std::thread &consumer : consumers)
+			consumer.join();
+	}
+	SharedBuffer header = payload.slice(0, 8);
+	SharedBuffer body = payload.slice(8, payload.getSize() - 8);
+	BinaryStream slice_stream(Buffer(const_cast<std::uint8_t *>(body.getBinary()), body.getSize(), 0, false, false));
+	printf("SharedSlice: %zu references, first 0x%x, body starts at %u\n", payload.getUseCount(), header.view().at(7), slice_stream.read<std::uint32_t>());
+	payload = SharedBuffer();
+	header = SharedBuffer();
+	printf("SharedLastReference: %zu\n", body.getUseCount());
+	try {
+		body.slice(990, 20);
+	} catch (std::out_of_range &error) {
+		printf("%s\n", error.what());
+	}
+	stream->reset(true);
+	stream->writeStringVarInt("tiny");
+	SharedBuffer tiny = SharedBuffer::freeze(std::move(*stream->getBuffer()));
+	printf("SharedFreezeInline: %.*s\n", static_cast<int>(tiny.getSize() - 1), (const char *)tiny.getBinary() + 1);
+
+	printf("BufferPool:\n");
+
+	BufferPool::Config pool_config;
+	pool_config.enabled = true;
+	BufferPool::configure(pool_config);
+	std::vector<std::uint8_t> pool_payload(4000, 0x5a);
+	BufferPool::Stats pool_before = BufferPool::getStats();
+	std::size_t pooled_capacity = 0;
+	for (std::size_t i = 0; i < 1000; ++i) {
+		Buffer pooled = Buffer::create();
+		pooled.writeAligned(pool_payload.data(), 1000);
+		pooled_capacity = pooled.capacity;
+	}
+	BufferPool::Stats pool_after = BufferPool::getStats();
+	printf("PoolRecycle: %zu hits, %zu misses, capacity %zu\n", pool_after.hits - pool_before.hits, pool_after.misses - pool_before.misses, pooled_capacity);
+	{
+		pool_before = BufferPool::getStats();
+		std::vector<std::thread> workers;
+		for (std::size_t t = 0; t < 4; ++t)
+			workers.emplace_back([&pool_payload] {
+				for (std::size_t i = 0; i < 1000; ++i) {
+					Buffer pooled = Buffer::create();
+					pooled.writeAligned(pool_payload.data(), pool_payload.size());
+				}
+			});
+		for (std::thread &worker : workers)
+			worker.join();
+		pool_after = BufferPool::getStats();
+		std::size_t new_blocks = pool_after.misses - pool_before.misses;
+		printf("PoolThreads: %zu acquisitions, retained after exit matches: %d\n", (pool_after.hits - pool_before.hits) + new_blocks, pool_after.retained_bytes == 1024 + new_blocks * 4096 ? 1 : 0);
+	}
+	BufferPool::trim();
+	pool_config.max_list_length = 4;
+	pool_config.max_depot_bytes = 8192;
+	BufferPool::configure(pool_config);
+	{
+		pool_before = BufferPool::getStats();
+		std::vector<std::uint8_t *> blocks;
+		std::size_t block_capacity = 0;
+		for (std::size_t i = 0; i < 16; ++i)
+			blocks.push_back(BufferPool::acquire(4000, block_capacity));
+		for (std::uint8_t *block : blocks)
+			BufferPool::release(block, block_capacity);
+		pool_after = BufferPool::getStats();
+		printf("PoolBounded: %zu retained bytes, %zu dropped\n", pool_after.retained_bytes, pool_after.dropped - pool_before.dropped);
+	}
+	BufferPool::trim();
+	printf("PoolTrim: %zu retained bytes\n", BufferPool::getStats().retained_bytes);
+	BufferPool::configure(BufferPool::Config());
+
+	printf("AdoptStorage:\n");
+
+	{
+		std::vector<std::uint8_t> received(1000);
+		for (std::size_t i = 0; i < received.size(); ++i)
+			received[i] = static_cast<std::uint8_t>(i);
+		const std::uint8_t *received_binary = received.data();
+		allocations_before = allocation_count;
+		BinaryStream adopted(Buffer::adopt(std::move(received)));
+		std::size_t adopt_allocations = allocation_count - allocations_before;
+		bool adopt_zero_copy = adopted.getBuffer()->binary == received_binary;
+		adopted.ignoreBytes(100);
+		std::uint32_t adopted_value = adopted.read<std::uint32_t>(false);
+		allocations_before = allocation_count;
+		std::vector<std::uint8_t> returned = adopted.getBuffer()->releaseVector();
+		printf("AdoptVector: zero-copy %d, %zu allocations, read 0x%x, released zero-copy %d with %zu allocations (%zu bytes, buffer left with %zu)\n", adopt_zero_copy ? 1 : 0, adopt_allocations, adopted_value, returned.data() == received_binary ? 1 : 0, allocation_count - allocations_before, returned.size(), adopted.getBuffer()->size);
+
+		std::string record(300, 'r');
+		const char *record_binary = record.data();
+		Buffer record_buffer = Buffer::adopt(std::move(record));
+		std::string stored = record_buffer.releaseString();
+		printf("AdoptString: released zero-copy %d (%zu bytes)\n", stored.data() == record_binary ? 1 : 0, stored.size());
+
+		Buffer grown = Buffer::adopt(std::string(100, 'g'));
+		grown.writeAligned(reinterpret_cast<const std::uint8_t *>("more"), 4);
+		std::string grown_string = grown.releaseString();
+		printf("AdoptGrow: %zu bytes, ends with %s, buffer left with %zu\n", grown_string.size(), grown_string.c_str() + 100, grown.size);
+
+		std::size_t foreign_frees = 0;
+		std::uint8_t *foreign = new std::uint8_t[16]();
+		{
+			Buffer foreign_buffer = Buffer::adopt(foreign, 16, [](std::uint8_t *binary, void *context) {
+				delete[] binary;
+				++*static_cast<std::size_t *>(context);
+			}, &foreign_frees);
+			Buffer moved_buffer(std::move(foreign_buffer));
+			printf("AdoptDeleter: releaseBinary %d, ", moved_buffer.releaseBinary() == nullptr ? 1 : 0);
+		}
+		printf("frees %zu\n", foreign_frees);
+
+		const std::uint8_t wrapped_binary[] = {0x00, 0x2a};
+		BinaryStream wrapped(Buffer::wrap(wrapped_binary, sizeof(wrapped_binary)));
+		printf("Wrap: %u, ", wrapped.read<std::uint16_t>());
+		try {
+			wrapped.write<std::uint8_t>(1);
+		} catch (std::invalid_argument &error) {
+			printf("%s\n", error.what());
+		}
+	}
+
+	printf("AlignedBuffer:\n");
+
+	{
+		Buffer line_buffer = Buffer::create(true, 100, Buffer::Alignment::CacheLine);
+		bool line_aligned = reinterpret_cast<std::uintptr_t>(line_buffer.binary) % 64 == 0;
+		for (std::uint32_t i = 0; i < 10000; ++i) {
+			line_buffer.writeAligned(reinterpret_cast<const std::uint8_t *>(&i), sizeof(i));
+			line_aligned &= reinterpret_cast<std::uintptr_t>(line_buffer.binary) % 64 == 0;
+		}
+		std::uint32_t line_last;
+		std::memcpy(&line_last, line_buffer.binary + line_buffer.size - 4, 4);
+		printf("CacheLine: aligned %d, %zu bytes, last %u\n", line_aligned ? 1 : 0, line_buffer.size, line_last);
+
+		Buffer page_buffer = Buffer::create(true, 10, Buffer::Alignment::Page);
+		bool page_aligned = reinterpret_cast<std::uintptr_t>(page_buffer.binary) % 4096 == 0;
+		page_buffer.reserve(100000);
+		page_aligned &= reinterpret_cast<std::uintptr_t>(page_buffer.binary) % 4096 == 0;
+		printf("Page: aligned %d, inline %d\n", page_aligned ? 1 : 0, page_buffer.isInline() ? 1 : 0);
+
+		Buffer huge_buffer = Buffer::create(true, 1 << 20, Buffer::Alignment::HugePage);
+		huge_buffer.writeAligned(pool_payload.data(), pool_payload.size());
+		bool huge_page_aligned = reinterpret_cast<std::uintptr_t>(huge_buffer.binary) % 4096 == 0;
+		huge_buffer.reserve(5 << 20);
+		bool huge_aligned = reinterpret_cast<std::uintptr_t>(huge_buffer.binary) % (2 << 20) == 0;
+		printf("HugePage: page aligned %d, huge aligned %d after growth, capacity %zu MiB, kept %d, releaseBinary %d\n", huge_page_aligned ? 1 : 0, huge_aligned ? 1 : 0, huge_buffer.capacity >> 20, std::memcmp(huge_buffer.binary, pool_payload.data(), pool_payload.size()) == 0 ? 1 : 0, huge_buffer.releaseBinary() == nullptr ? 1 : 0);
+
+		Buffer fixed_huge = Buffer::create(false, 3 << 20, Buffer::Alignment::HugePage);
+		std::vector<std::uint8_t> huge_payload(3 << 20, 0x11);
+		fixed_huge.writeAligned(huge_payload.data(), huge_payload.size());
+		try {
+			fixed_huge.writeSingle(0);
+		} catch (exceptions::EndOfStream &error) {
+			printf("%s\n", error.what());
+		}
+	}
+
+	printf("Skip:\n");
+
+	{
+		stream->reset(true);
+		stream->write<std::uint32_t>(7);
+		stream->writeStringVarInt(std::string(300, 's'));
+		stream->writeString<std::uint16_t>("skipped");
+		stream->writeVarInt<std::uint64_t>(std::numeric_limits<std::uint64_t>::max());
+		stream->writeZigZag<std::int32_t>(-123456);
+		stream->writeVarInt<std::uint32_t>(1);
+		stream->writeOptional([](BinaryStream *target) { target->writeStringVarInt("optional"); });
+		stream->writeOptional(std::nullopt);
+		stream->writeBits<std::uint32_t>(0b101, 3);
+		stream->writeBits<std::uint32_t>(0xabcd, 16);
+		stream->writeBits<std::uint32_t>(0b11, 2);
+		stream->flushBitWriter();
+		stream->write<uint24_t>(0x123456);
+		stream->write<std::uint8_t>(0x42);
+		allocations_before = allocation_count;
+		stream->skip<std::uint32_t>();
+		stream->skipStringVarInt();
+		stream->skipString<std::uint16_t>();
+		stream->skipVarInt<std::uint64_t>();
+		stream->skipZigZag<std::int32_t>();
+		stream->skipVarInt();
+		bool first_optional = stream->skipOptional([](BinaryStream *source) { source->skipStringVarInt(); });
+		bool second_optional = stream->skipOptional([](BinaryStream *source) { source->skipStringVarInt(); });
+		stream->skipBits(3);
+		std::uint32_t kept_bits = stream->readBits<std::uint32_t>(16);
+		stream->skipBits(2);
+		stream->resetBitReader();
+		stream->skip<uint24_t>();
+		std::size_t skip_allocations = allocation_count - allocations_before;
+		printf("SkipFields: 0x%x, optionals %d %d, bits 0x%x, %zu allocations\n", stream->read<std::uint8_t>(), first_optional ? 1 : 0, second_optional ? 1 : 0, kept_bits, skip_allocations);
+
+		std::size_t skip_passed = 0;
+		for (std::size_t length = 1; length <= 10; ++length) {
+			stream->reset(true);
+			for (std::size_t i = 0; i + 1 < length; ++i)
+				stream->write<std::uint8_t>(0x80 | static_cast<std::uint8_t>(i));
+			stream->write<std::uint8_t>(0x01);
+			stream->write<std::uint8_t>(0x99);
+			stream->skipVarInt<std::uint64_t>();
+			skip_passed += stream->read<std::uint8_t>() == 0x99;
+		}
+		printf("SkipVarIntLengths: %zu/10\n", skip_passed);
+
+		// with 8 bytes left the uint32 varints are skipped with the word scan.
+		stream->reset(true);
+		stream->writeVarInt<std::uint32_t>(0xffffffff);
+		stream->write<std::uint8_t>(0x99);
+		stream->writePadding(0, 8);
+		stream->skipVarInt<std::uint32_t>();
+		bool word_skipped = stream->read<std::uint8_t>() == 0x99;
+		stream->reset(true);
+		for (std::size_t i = 0; i < 5; ++i)
+			stream->write<std::uint8_t>(0xff);
+		stream->write<std::uint8_t>(0x01);
+		stream->writePadding(0, 8);
+		bool word_too_big = false;
+		try {
+			stream->skipVarInt<std::uint32_t>();
+		} catch (exceptions::VarIntTooBig &) {
+			word_too_big = true;
+		}
+		printf("SkipVarIntWord: skipped %d, too big %d\n", word_skipped ? 1 : 0, word_too_big ? 1 : 0);
+
+		stream->reset(true);
+		for (std::size_t i = 0; i < 12; ++i)
+			stream->write<std::uint8_t>(0xff);
+		try {
+			stream->skipVarInt<std::uint64_t>();
+		} catch (exceptions::VarIntTooBig &error) {
+			printf("%s\n", error.what());
+		}
+		stream->setPosition(0);
+		try {
+			stream->skipZigZag<std::int32_t>();
+		} catch (exceptions::ZigZagTooBig &error) {
+			printf("%s\n", error.what());
+		}
+		stream->reset(true);
+		stream->write<std::uint8_t>(0x80);
+		stream->write<std::uint8_t>(0x80);
+		try {
+			stream->skipVarInt();
+		} catch (exceptions::EndOfStream &error) {
+			printf("%s\n", error.what());
+		}
+		stream->setPosition(0);
+		try {
+			stream->skipBits(17);
+		} catch (exceptions::EndOfStream &error) {
+			printf("%s\n", error.what());
+		}
+	}
+
+	printf("LazyRecord:\n");
+
+	{
+		using Route = LazyRecord<fields::Fixed<std::uint16_t>, fields::StringVarInt<>, fields::VarInt<std::uint64_t>, fields::Optional<fields::ZigZag<>>, fields::BytesVarInt<>, fields::Float<double, false>, fields::String<std::uint16_t>>;
+		stream->reset(true);
+		for (std::uint16_t i = 0; i < 2; ++i) {
+			stream->write<std::uint16_t>(19132 + i);
+			stream->writeStringVarInt(std::string(300, 'p'));
+			stream->writeVarInt<std::uint64_t>(1ull << 40);
+			stream->writeOptional([](BinaryStream *target) { target->writeZigZag<std::int32_t>(-77); });
+			stream->writeStringVarInt("payload");
+			stream->writeFloat<double>(2.5, false);
+			stream->writeString<std::uint16_t>("destination");
+		}
+		allocations_before = allocation_count;
+		Route route(stream);
+		std::size_t scan_allocations = allocation_count - allocations_before;
+		std::uint16_t route_port = route.get<0>();
+		const std::string &destination = route.get<6>();
+		allocations_before = allocation_count;
+		const std::string &destination_again = route.get<6>();
+		printf("LazyAccess: scan %zu allocations, port %u, destination %s, cached %d (%zu allocations), decoded %d%d%d, size %zu, next at %zu\n", scan_allocations, route_port, destination.c_str(), &destination == &destination_again ? 1 : 0, allocation_count - allocations_before, route.isDecoded<0>() ? 1 : 0, route.isDecoded<1>() ? 1 : 0, route.isDecoded<6>() ? 1 : 0, route.getSize(), stream->getNumOfBytesRead());
+		printf("LazyFields: %llu, %d, %.*s, %.1f, name at %zu\n", static_cast<unsigned long long>(route.get<2>()), *route.get<3>(), static_cast<int>(route.get<4>().size), (const char *)route.get<4>().binary, route.get<5>(), route.getOffset<1>());
+		auto eager = readRecord<fields::Fixed<std::uint16_t>, fields::StringVarInt<>, fields::VarInt<std::uint64_t>, fields::Optional<fields::ZigZag<>>, fields::BytesVarInt<>, fields::Float<double, false>, fields::String<std::uint16_t>>(stream);
+		printf("EagerRecord: %u, %zu, %d, %s, eos %d\n", std::get<0>(eager), std::get<1>(eager).size(), *std::get<3>(eager), std::get<6>(eager).c_str(), stream->eos() ? 1 : 0);
+
+		BasicBinaryStream<LittleEndian, Unchecked> policy_stream;
+		policy_stream.write<std::uint32_t>(0xcafebabe);
+		policy_stream.writeStringVarInt("policy");
+		policy_stream.write<std::uint16_t>(0x1234);
+		auto policy_record = scanRecord<fields::Fixed<std::uint32_t>, fields::StringVarInt<>, fields::Fixed<std::uint16_t>>(&policy_stream);
+		printf("LazyPolicyStream: 0x%x, %s, 0x%x, size %zu\n", policy_record.get<0>(), policy_record.get<1>().c_str(), policy_record.get<2>(), policy_record.getSize());
+	}
+
+	printf("VarIntWideLoad:\n");
+
+	{
+		std::size_t varint_passed = 0;
+		std::uint64_t varint_seed = 0x9e3779b97f4a7c15;
+		std::vector<std::uint64_t> varint_values;
+		for (std::size_t i = 0; i < 4096; ++i) {
+			varint_seed ^= varint_seed << 13;
+			varint_seed ^= varint_seed >> 7;
+			varint_seed ^= varint_seed << 17;
+			varint_values.push_back(varint_seed >> (varint_seed & 63));
+		}
+		varint_values.push_back(std::numeric_limits<std::uint64_t>::max());
+		varint_values.push_back(0);
+		stream->reset(true);
+		for (std::uint64_t value : varint_values) {
+			stream->writeVarInt<std::uint64_t>(value);
+			stream->writeVarInt<std::uint32_t>(static_cast<std::uint32_t>(value));
+			stream->writeVarInt<std::uint16_t>(static_cast<std::uint16_t>(value));
+			stream->writeVarInt<std::uint8_t>(static_cast<std::uint8_t>(value));
+		}
+		for (std::uint64_t value : varint_values) {
+			varint_passed += stream->readVarInt<std::uint64_t>() == value;
+			varint_passed += stream->readVarInt<std::uint32_t>() == static_cast<std::uint32_t>(value);
+			varint_passed += stream->readVarInt<std::uint16_t>() == static_cast<std::uint16_t>(value);
+			varint_passed += stream->readVarInt<std::uint8_t>() == static_cast<std::uint8_t>(value);
+		}
+		printf("VarIntRoundTrip: %zu/%zu, eos %d\n", varint_passed, varint_values.size() * 4, stream->eos() ? 1 : 0);
+
+		stream->reset(true);
+		for (std::size_t i = 0; i < 6; ++i)
+			stream->write<std::uint8_t>(0xff);
+		stream->write<std::uint8_t>(0x01);
+		stream->write<std::uint32_t>(0);
+		try {
+			stream->readVarInt<std::uint32_t>();
+		} catch (exceptions::VarIntTooBig &error) {
+			printf("%s\n", error.what());
+		}
+		stream->setPosition(0);
+		printf("VarIntWide: 0x%llx\n", static_cast<unsigned long long>(stream->readVarInt<std::uint64_t>()));
+	}
+
+	printf("BufferAllocator:\n");
+
+	{
+		MallocAllocator tracking;
+		{
+			BinaryStream tracked(Buffer::create(true, 256, Buffer::Alignment::Default, &tracking));
+			for (std::uint32_t i = 0; i < 2500; ++i)
+				tracked.write<std::uint32_t>(i);
+			BufferAllocator::Stats grown = tracking.getStats();
+			printf("AllocatorGrow: %zu allocations, %zu reallocations, %zu bytes in use (capacity %zu)\n", grown.allocations, grown.reallocations, grown.bytes_in_use, tracked.getBuffer()->capacity);
+			tracked.reset(true, 1000);
+			tracked.writePadding(0, 2000);
+			BinaryStream tracked_clone = tracked.clone();
+			printf("AllocatorReset: same allocator %d, clone allocator %d\n", tracked.getBuffer()->getAllocator() == &tracking ? 1 : 0, tracked_clone.getBuffer()->getAllocator() == &tracking ? 1 : 0);
+		}
+		BufferAllocator::Stats released = tracking.getStats();
+		printf("AllocatorReleased: %zu allocations, %zu deallocations, %zu bytes in use, peak %zu\n", released.allocations, released.deallocations, released.bytes_in_use, released.peak_bytes);
+
+		PoolAllocator pooled_allocator;
+		std::size_t pooled_allocator_capacity = 0;
+		for (std::size_t i = 0; i < 100; ++i) {
+			Buffer pooled = Buffer::create(false, 1000, Buffer::Alignment::Default, &pooled_allocator);
+			pooled.writeAligned(pool_payload.data(), 1000);
+			pooled_allocator_capacity = pooled.capacity;
+		}
+		BufferAllocator::Stats pooled_stats = pooled_allocator.getStats();
+		printf("PoolAllocator: %zu allocations, %zu deallocations, peak %zu, capacity %zu, good size %zu\n", pooled_stats.allocations, pooled_stats.deallocations, pooled_stats.peak_bytes, pooled_allocator_capacity, pooled_allocator.goodSize(1000));
+		BufferPool::trim();
+
+		ArenaAllocator arena;
+		{
+			Buffer arena_buffer = Buffer::create(true, 100, Buffer::Alignment::CacheLine, &arena);
+			bool arena_aligned = true;
+			for (std::uint32_t i = 0; i < 1000; ++i) {
+				arena_buffer.writeAligned(reinterpret_cast<const std::uint8_t *>(&i), sizeof(i));
+				arena_aligned &= reinterpret_cast<std::uintptr_t>(arena_buffer.binary) % 64 == 0;
+			}
+			printf("ArenaAllocator: aligned %d, releaseBinary %d, ", arena_aligned ? 1 : 0, arena_buffer.releaseBinary() == nullptr ? 1 : 0);
+		}
+		BufferAllocator::Stats arena_stats = arena.getStats();
+		printf("%zu allocations, %zu reallocations, %zu deallocations, %zu bytes in use\n", arena_stats.allocations, arena_stats.reallocations, arena_stats.deallocations, arena_stats.bytes_in_use);
+	}
+
+	printf("LengthPrefix:\n");
+	{
+		BinaryStream patched;
+		patched.beginLengthPrefixed<std::uint16_t>();
+		patched.writeString<std::uint8_t>("header");
+		patched.beginLengthPrefixedVarInt<std::uint32_t>();
+		for (std::uint32_t i = 0; i < 50; ++i)
+			patched.writeVarInt<std::uint32_t>(i * 1000);
+		std::size_t inner_length = patched.endLengthPrefixed();
+		patched.write<std::uint32_t>(0xdeadbeef);
+		std::size_t outer_length = patched.endLengthPrefixed();
+
+		BinaryStream inner;
+		for (std::uint32_t i = 0; i < 50; ++i)
+			inner.writeVarInt<std::uint32_t>(i * 1000);
+		BinaryStream outer;
+		outer.writeString<std::uint8_t>("header");
+		outer.writeVarInt<std::uint32_t>(static_cast<std::uint32_t>(inner.getBuffer()->size));
+		outer.getBuffer()->writeAligned(inner.getBuffer()->binary, inner.getBuffer()->size);
+		outer.write<std::uint32_t>(0xdeadbeef);
+		BinaryStream expected;
+		expected.write<std::uint16_t>(static_cast<std::uint16_t>(outer.getBuffer()->size));
+		expected.getBuffer()->writeAligned(outer.getBuffer()->binary, outer.getBuffer()->size);
+		bool same = patched.getBuffer()->size == expected.getBuffer()->size && std::memcmp(patched.getBuffer()->binary, expected.getBuffer()->binary, expected.getBuffer()->size) == 0;
+		printf("LengthPrefixNested: inner %zu, outer %zu, size %zu, matches %d\n", inner_length, outer_length, patched.getBuffer()->size, same ? 1 : 0);
+
+		BinaryStream padded;
+		padded.beginLengthPrefixedVarInt<std::uint32_t>(false);
+		padded.writePadding(0, 200);
+		padded.endLengthPrefixed();
+		padded.write<std::uint8_t>(7);
+		std::uint32_t padded_length = padded.readVarInt<std::uint32_t>();
+		padded.ignoreBytes(padded_length);
+		printf("LengthPrefixPadded: size %zu, length %u, trailer %u\n", padded.getBuffer()->size, padded_length, padded.read<std::uint8_t>());
+
+		BinaryStream too_big;
+		too_big.beginLengthPrefixed<std::uint8_t>();
+		too_big.writePadding(0, 300);
+		try {
+			too_big.endLengthPrefixed();
+			printf("LengthPrefixTooBig: not thrown\n");
+		} catch (const exceptions::FrameTooBig &) {
+			printf("LengthPrefixTooBig: thrown\n");
+		}
+
+		BinaryStream replaced;
+		replaced.writePadding(0, 1000);
+		replaced.beginLengthPrefixed<std::uint64_t>();
+		replaced.reset(true);
+		bool replaced_thrown = false;
+		try {
+			replaced.endLengthPrefixed();
+		} catch (const std::runtime_error &) {
+			replaced_thrown = true;
+		}
+		BinaryStream cleared;
+		cleared.writePadding(0, 1000);
+		cleared.beginLengthPrefixed<std::uint64_t>();
+		cleared.getBuffer()->clear();
+		bool cleared_thrown = false;
+		try {
+			cleared.endLengthPrefixed();
+		} catch (const std::runtime_error &) {
+			cleared_thrown = true;
+		}
+		printf("LengthPrefixReplaced: reset thrown %d, clear thrown %d\n", replaced_thrown ? 1 : 0, cleared_thrown ? 1 : 0);
+	}
+
+	printf("BatchWriter:\n");
+	{
+		std::vector<Buffer> batch_buffers;
+		for (std::uint32_t i = 0; i < 3000; ++i) {
+			batch_buffers.push_back(Buffer::create(true, 8));
+			batch_buffers.back().writeAligned(reinterpret_cast<const std::uint8_t *>(&i), sizeof(i));
+		}
+		FILE *batch_file = std::tmpfile();
+		BatchWriter file_writer(fileno(batch_file));
+		for (const Buffer &buffer : batch_buffers)
+			file_writer.add(buffer);
+		std::size_t file_flushed = file_writer.flush();
+		std::vector<std::uint32_t> file_values(3000);
+		::pread(fileno(batch_file), file_values.data(), file_values.size() * sizeof(std::uint32_t), 0);
+		bool file_matches = true;
+		for (std::uint32_t i = 0; i < 3000; ++i)
+			file_matches &= file_values[i] == i;
+		printf("BatchWriterFile: %zu bytes, %zu writev calls for %zu buffers, matches %d\n", file_flushed, file_writer.getNumOfCalls(), batch_buffers.size(), file_matches ? 1 : 0);
+		std::fclose(batch_file);
+
+		int batch_sockets[2];
+		::socketpair(AF_UNIX, SOCK_STREAM, 0, batch_sockets);
+		::fcntl(batch_sockets[0], F_SETFL, ::fcntl(batch_sockets[0], F_GETFL) | O_NONBLOCK);
+		std::vector<std::uint8_t> batch_payload(1000);
+		for (std::size_t i = 0; i < batch_payload.size(); ++i)
+			batch_payload[i] = static_cast<std::uint8_t>(i * 7);
+		BatchWriter socket_writer(batch_sockets[0]);
+		for (std::size_t i = 0; i < 1000; ++i)
+			socket_writer.add(BufferView(batch_payload.data() + (i % 10), batch_payload.size() - (i % 10)));
+		std::size_t socket_expected = socket_writer.getPendingSize();
+		std::vector<std::uint8_t> socket_received;
+		std::uint8_t socket_chunk[65536];
+		bool socket_resumed = false;
+		while (!socket_writer.empty()) {
+			socket_writer.flush();
+			socket_resumed |= !socket_writer.empty();
+			ssize_t received;
+			while ((received = ::recv(batch_sockets[1], socket_chunk, sizeof(socket_chunk), MSG_DONTWAIT)) > 0)
+				socket_received.insert(socket_received.end(), socket_chunk, socket_chunk + received);
+		}
+		bool socket_matches = socket_received.size() == socket_expected;
+		for (std::size_t i = 0, offset = 0; socket_matches && i < 1000; offset += batch_payload.size() - (i % 10), ++i)
+			socket_matches = std::memcmp(socket_received.data() + offset, batch_payload.data() + (i % 10), batch_payload.size() - (i % 10)) == 0;
+		printf("BatchWriterSocket: %zu bytes, resumed %d, fewer calls %d, matches %d\n", socket_writer.getNumOfBytesWritten(), socket_resumed ? 1 : 0, socket_writer.getNumOfCalls() < 1000 ? 1 : 0, socket_matches ? 1 : 0);
+		::close(batch_sockets[0]);
+		::close(batch_sockets[1]);
+	}
+
+	printf("BatchReceiver:\n");
+	{
+		int datagram_sockets[2];
+		::socketpair(AF_UNIX, SOCK_DGRAM, 0, datagram_sockets);
+		::fcntl(datagram_sockets[1], F_SETFL, ::fcntl(datagram_sockets[1], F_GETFL) | O_NONBLOCK);
+		for (std::uint32_t i = 0; i < 100; ++i) {
+			BinaryStream datagram;
+			datagram.writeVarInt<std::uint32_t>(i * 100);
+			datagram.writeStringVarInt(std::string(i, 'd'));
+			::send(datagram_sockets[0], datagram.getBuffer()->binary, datagram.getBuffer()->size, 0);
+			if (i == 50)
+				::send(datagram_sockets[0], pool_payload.data(), 1000, 0);
+		}
+		BatchReceiver datagram_receiver(datagram_sockets[1], 16, 256);
+		std::vector<Buffer> datagrams;
+		std::size_t datagram_count = 0, datagram_calls = 0;
+		bool datagrams_match = true;
+		while (datagram_receiver.receiveDatagrams(datagrams) > 0) {
+			++datagram_calls;
+			for (Buffer &datagram : datagrams) {
+				BinaryStream decoded(std::move(datagram));
+				std::uint32_t index = static_cast<std::uint32_t>(datagram_count++);
+				datagrams_match &= decoded.readVarInt<std::uint32_t>() == index * 100 && decoded.readStringVarInt() == std::string(index, 'd') && decoded.eos();
+				datagram_receiver.recycle(std::move(*decoded.getBuffer()));
+			}
+			datagrams.clear();
+		}
+		printf("BatchReceiverDatagrams: %zu datagrams in %zu calls, matches %d, truncated %zu, allocations %zu\n", datagram_count, datagram_calls, datagrams_match ? 1 : 0, datagram_receiver.getNumOfTruncated(), datagram_receiver.getNumOfAllocations());
+		::close(datagram_sockets[0]);
+		::close(datagram_sockets[1]);
+
+		int stream_sockets[2];
+		::socketpair(AF_UNIX, SOCK_STREAM, 0, stream_sockets);
+		::send(stream_sockets[0], pool_payload.data(), pool_payload.size(), 0);
+		::close(stream_sockets[0]);
+		BatchReceiver stream_receiver(stream_sockets[1], 8, 256);
+		std::vector<Buffer> chunks;
+		std::vector<std::uint8_t> stream_received;
+		while (stream_receiver.receiveStream(chunks) > 0) {
+			for (const Buffer &chunk : chunks)
+				stream_received.insert(stream_received.end(), chunk.binary, chunk.binary + chunk.size);
+			stream_receiver.recycle(chunks);
+		}
+		printf("BatchReceiverStream: %zu bytes, eof %d, matches %d, allocations %zu\n", stream_received.size(), stream_receiver.eof() ? 1 : 0, stream_received == pool_payload ? 1 : 0, stream_receiver.getNumOfAllocations());
+		::close(stream_sockets[1]);
+
+		int foreign_sockets[2];
+		::socketpair(AF_UNIX, SOCK_DGRAM, 0, foreign_sockets);
+		::send(foreign_sockets[0], "first", 5, 0);
+		::send(foreign_sockets[0], "second", 6, 0);
+		BatchReceiver foreign_receiver(foreign_sockets[1], 2, 64);
+		std::vector<Buffer> held;
+		foreign_receiver.receiveDatagrams(held);
+		static const std::uint8_t foreign_binary[64] = {};
+		foreign_receiver.recycle(Buffer::wrap(foreign_binary, sizeof(foreign_binary)));
+		foreign_receiver.recycle(Buffer::adopt(std::vector<std::uint8_t>(64)));
+		::send(foreign_sockets[0], "third", 5, 0);
+		::send(foreign_sockets[0], "fourth", 6, 0);
+		std::vector<Buffer> foreign_received;
+		foreign_receiver.receiveDatagrams(foreign_received);
+		bool foreign_untouched = std::all_of(foreign_binary, foreign_binary + sizeof(foreign_binary), [](std::uint8_t byte) { return byte == 0; });
+		printf("BatchReceiverForeign: received %zu, untouched %d, allocations %zu\n", held.size() + foreign_received.size(), foreign_untouched ? 1 : 0, foreign_receiver.getNumOfAllocations());
+		::close(foreign_sockets[0]);
+		::close(foreign_sockets[1]);
+	}
+
+	printf("ProtoWire:\n");
+	{
+		auto proto_hex = [](BinaryStream &encoded) {
+			std::string hex;
+			char digits[4];
+			for (std::size_t i = 0; i < encoded.getBuffer()->size; ++i) {
+				std::snprintf(digits, sizeof(digits), "%02x ", encoded.getBuffer()->binary[i]);
+				hex += digits;
+			}
+			encoded.reset(true);
+			return hex;
+		};
+		BinaryStream encoded;
+		protobuf::ProtoWriter proto_writer(&encoded);
+		proto_writer.writeUInt32(1, 150);
+		printf("ProtoVarInt: %s\n", proto_hex(encoded).c_str());
+		proto_writer.writeString(2, "testing");
+		printf("ProtoString: %s\n", proto_hex(encoded).c_str());
+		proto_writer.beginMessage(3);
+		proto_writer.writeUInt32(1, 150);
+		proto_writer.endMessage();
+		printf("ProtoMessage: %s\n", proto_hex(encoded).c_str());
+		const std::uint32_t packed_values[] = {3, 270, 86942};
+		proto_writer.writePackedVarInt(4, packed_values, 3);
+		printf("ProtoPacked: %s\n", proto_hex(encoded).c_str());
+		proto_writer.writeInt32(1, -1);
+		proto_writer.writeSInt32(2, -1);
+		proto_writer.writeSInt64(3, -2);
+		printf("ProtoSigned: %s\n", proto_hex(encoded).c_str());
+		proto_writer.writeFixed32<std::uint32_t>(5, 1);
+		proto_writer.writeFixed64<double>(1, 1.0);
+		printf("ProtoFixed: %s\n", proto_hex(encoded).c_str());
+
+		// a message with unknown fields of every wire type around the known ones.
+		const std::int32_t zigzag_values[] = {-1, 0, 1, -1000000, 1000000};
+		const float float_values[] = {0.5f, -2.0f};
+		proto_writer.writeUInt64(100, 0xffffffffffffffff);
+		proto_writer.writeString(1, "player");
+		proto_writer.writeFixed64<std::uint64_t>(101, 42);
+		proto_writer.beginMessage(2);
+		proto_writer.writeInt64(1, -5);
+		proto_writer.beginMessage(102);
+		proto_writer.writeString(1, "nested unknown");
+		proto_writer.endMessage();
+		proto_writer.writeBool(2, true);
+		proto_writer.endMessage();
+		proto_writer.writeTag(103, protobuf::WireType::StartGroup);
+		proto_writer.writeUInt32(1, 7);
+		proto_writer.writeFixed32<float>(2, 1.5f);
+		proto_writer.writeTag(103, protobuf::WireType::EndGroup);
+		proto_writer.writePackedZigZag(3, zigzag_values, 5);
+		proto_writer.writeUInt32(4, 9);
+		proto_writer.writeUInt32(4, 10);
+		proto_writer.writePackedFixed(5, float_values, 2);
+
+		std::string proto_name;
+		std::int64_t proto_nested_value = 0;
+		bool proto_nested_flag = false;
+		std::vector<std::int32_t> proto_zigzag;
+		std::vector<std::uint32_t> proto_unpacked;
+		std::vector<float> proto_floats;
+		std::size_t proto_skipped = 0;
+		protobuf::ProtoReader proto_reader(&encoded);
+		while (proto_reader.next()) {
+			switch (proto_reader.getField()) {
+			case 1:
+				proto_name = proto_reader.readString();
+				break;
+			case 2:
+				proto_reader.readMessage([&](protobuf::ProtoReader &nested) {
+					while (nested.next()) {
+						if (nested.getField() == 1)
+							proto_nested_value = nested.readInt64();
+						else if (nested.getField() == 2)
+							proto_nested_flag = nested.readBool();
+						else {
+							nested.skip();
+							++proto_skipped;
+						}
+					}
+				});
+				break;
+			case 3:
+				proto_reader.readPackedZigZag(proto_zigzag);
+				break;
+			case 4:
+				proto_reader.readPackedVarInt(proto_unpacked);
+				break;
+			case 5:
+				proto_reader.readPackedFixed(proto_floats);
+				break;
+			default:
+				proto_reader.skip();
+				++proto_skipped;
+			}
+		}
+		bool proto_matches = proto_name == "player" && proto_nested_value == -5 && proto_nested_flag && proto_zigzag == std::vector<std::int32_t>(zigzag_values, zigzag_values + 5) && proto_unpacked == std::vector<std::uint32_t>{9, 10} && proto_floats == std::vector<float>(float_values, float_values + 2);
+		printf("ProtoRoundTrip: matches %d, skipped %zu, eos %d\n", proto_matches ? 1 : 0, proto_skipped, encoded.eos() ? 1 : 0);
+
+		encoded.reset(true);
+		proto_writer.beginMessage(1);
+		proto_writer.writeUInt32(1, 1);
+		proto_writer.endMessage();
+		encoded.getBuffer()->binary[1] = 10;
+		protobuf::ProtoReader truncated_reader(&encoded);
+		try {
+			truncated_reader.next();
+			truncated_reader.skip();
+			printf("ProtoTruncated: not thrown\n");
+		} catch (const exceptions::InvalidWireFormat &) {
+			printf("ProtoTruncated: thrown\n");
+		}
+
+		// 0x0b starts group 1 and 0x0c ends it.
+		encoded.reset(true);
+		encoded.writePadding(0x0b, protobuf::ProtoReader::MAX_GROUP_DEPTH);
+		encoded.writePadding(0x0c, protobuf::ProtoReader::MAX_GROUP_DEPTH);
+		encoded.writeVarInt<std::uint32_t>(8);
+		encoded.writeVarInt<std::uint32_t>(1);
+		protobuf::ProtoReader nested_groups(&encoded);
+		std::size_t nested_groups_fields = 0;
+		while (nested_groups.next()) {
+			nested_groups.skip();
+			++nested_groups_fields;
+		}
+		encoded.reset(true);
+		encoded.writePadding(0x0b, 2000000);
+		protobuf::ProtoReader deep_groups(&encoded);
+		bool deep_groups_thrown = false;
+		try {
+			while (deep_groups.next())
+				deep_groups.skip();
+		} catch (const exceptions::InvalidWireFormat &) {
+			deep_groups_thrown = true;
+		}
+		printf("ProtoGroupDepth: %zu fields after %zu nested groups, too deep thrown %d\n", nested_groups_fields, protobuf::ProtoReader::MAX_GROUP_DEPTH, deep_groups_thrown ? 1 : 0);
+	}
+
+	printf("FrameDecoder:\n");
+
+	stream->reset(true, 0);
+	for (std::uint32_t i = 0; i < 100; ++i) {
+		std::string payload(i * 3, static_cast<char>('a' + i % 26));
+		stream->writeStringVarInt(payload);
+	}
+	FrameDecoder frame_decoder(1024);
+	BufferView frame;
+	std::size_t frame_count = 0, frame_offset = 0, frame_chunk = 1;
+	bool frames_match = true;
+	while (frame_offset < stream->getBuffer()->position) {
+		std::size_t chunk = std::min(frame_chunk, stream->getBuffer()->position - frame_offset);
+		frame_decoder.feed(stream->getBuffer()->binary + frame_offset, chunk);
+		frame_offset += chunk;
+		frame_chunk = frame_chunk * 7 % 61 + 1;
+		while (frame_decoder.next(frame)) {
+			frames_match = frames_match && frame.size == frame_count * 3 && std::all_of(frame.begin(), frame.end(), [&](std::uint8_t byte) { return byte == 'a' + frame_count % 26; });
+			++frame_count;
+		}
+	}
+	printf("FrameCount: %zu (%d)\n", frame_count, frames_match ? 1 : 0);
+	printf("FrameBuffered: %zu\n", frame_decoder.getNumOfBytesBuffered());
+	std::uint8_t oversized_frame[] = {0x81, 0x10};
+	frame_decoder.feed(oversized_frame, 1);
+	printf("FramePeekIncomplete: %d\n", frame_decoder.peekFrameSize().has_value() ? 0 : 1);
+	frame_decoder.feed(oversized_frame + 1, 1);
+	try {
+		frame_decoder.next(frame);
+	} catch (exceptions::FrameTooBig &error) {
+		printf("%s\n", error.what());
+	}
+
+#ifdef __cpp_impl_coroutine
+	printf("ResumableDecoder:\n");
+
+	stream->reset(true, 0);
+	stream->writeVarInt<std::uint32_t>(300000);
+	stream->writeStringVarInt("Alex");
+	stream->writeString<std::uint16_t>("Steve");
+	stream->write<std::uint64_t>(0x1122334455667788, false);
+	stream->writeZigZag<std::int64_t>(-123456789);
+
+	ResumableReader reader;
+	DecodeTask<ResumableLogin> login_task = decodeResumableLogin(reader);
+	int resumable_chunks = 0;
+	for (std::size_t i = 0; i < stream->getBuffer()->position; ++i, ++resumable_chunks)
+		reader.feed(stream->getBuffer()->binary + i, 1);
+	ResumableLogin login = login_task.result();
+	printf("ResumableDone: %d after %d chunks\n", login_task.done() ? 1 : 0, resumable_chunks);
+	printf("ResumableLogin: %u %s 0x%llx %lld\n", login.id, login.name.c_str(), static_cast<unsigned long long>(login.stamp), static_cast<long long>(login.delta));
+#endif
+
 	delete stream;
 
 	return 0;